@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "stats.h"
+
+// Counting replacements for the global allocator. Linked only into the
+// binaries which report allocations, and each allocation only pays for a
+// relaxed flag load unless stats::count_allocations() is on
+namespace {
+	using namespace crafter::stats::detail;
+
+	void count_allocation(size_t size) {
+		if (counting.load(std::memory_order_relaxed)) {
+			allocation_count.fetch_add(1, std::memory_order_relaxed);
+			allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+	}
+}
+
+void* operator new(size_t size) {
+	count_allocation(size);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	if (ptr != nullptr && counting.load(std::memory_order_relaxed)) {
+		free_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+	::operator delete(ptr);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned overloads
+void* operator new(size_t size, std::align_val_t align) {
+	count_allocation(size);
+	auto alignment = std::max(static_cast<size_t>(align), sizeof(void*));
+	void* ptr = nullptr;
+	if (posix_memalign(&ptr, alignment, size == 0 ? 1 : size) == 0) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+	return ::operator new(size, align);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+	::operator delete(ptr);
+}
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "graph.h"
+#include "import.h"
+#include "lazy_recipes.h"
+#include "output.h"
+#include "perf.h"
+#include "stats.h"
+#include "plan.h"
+#include "planner.h"
+#include "recipe_gen.h"
+#include "recipe_index.h"
+#include "yaml-cpp/yaml.h"
+
+#define data_location "data/recipes/"
+
+struct bench_args {
+	size_t max_items = 1000000;
+	size_t repeat = 5;
+	size_t requests = 100;
+	bool perf = false;
+	// Share of aliased ingredient lists in the anchored packs
+	double shared = 0.5;
+	crafter::synthetic_options synthetic;
+};
+
+struct bench_input {
+	std::string name;
+	// Recipes are imported from either a directory or in memory files
+	std::string directory;
+	std::vector<std::string> files;
+	crafter::recipe_store recipes;
+	std::vector<crafter::Ingredients> requests;
+};
+
+bench_args read_args(int argc, char const *argv[]);
+void run_suite(bench_input& input, const bench_args& args, int sink);
+void print_perf(const crafter::perf::sample& taken);
+
+int main(int argc, char const *argv[]) {
+	auto args = read_args(argc, argv);
+	int sink = open("/dev/null", O_WRONLY);
+	if (sink < 0) {
+		std::cerr << "Failed to open /dev/null\n";
+		return 1;
+	}
+	// Every phase reports its allocations
+	crafter::stats::count_allocations();
+	if (args.perf) {
+		crafter::perf::enable();
+		if (!crafter::perf::enabled()) {
+			std::cerr << "perf_event_open is unavailable, check /proc/sys/kernel/perf_event_paranoid\n";
+		}
+	}
+	std::cout << "input\trecipes\tphase\tbest_ms\tmean_ms\tallocations\tallocated_bytes";
+	if (args.perf) {
+		std::cout << "\tipc\tbranch_miss_%\tl1d_miss_%\tllc_miss_%";
+	}
+	std::cout << "\n";
+
+	bench_input bundled;
+	bundled.name = "bundled";
+	bundled.directory = data_location;
+	bundled.recipes = crafter::read_templates(bundled.directory);
+	std::vector<std::string> names;
+	for (const auto& recipe : bundled.recipes) {
+		names.push_back(recipe.first);
+	}
+	std::sort(names.begin(), names.end());
+	for (size_t i = 0; i < names.size() && bundled.requests.size() < args.requests; i += std::max<size_t>(1, names.size() / args.requests)) {
+		bundled.requests.push_back(crafter::Ingredients(names[i], 1));
+	}
+	run_suite(bundled, args, sink);
+
+	for (size_t items = 1000; items <= args.max_items; items *= 10) {
+		// The same packs again with ingredient lists shared through anchors
+		for (bool anchored : {false, true}) {
+			auto options = args.synthetic;
+			options.items = items;
+			if (anchored) {
+				options.shared = args.shared;
+			}
+			auto pack = crafter::generate_recipes(options);
+			bench_input synthetic;
+			synthetic.name = anchored ? "anchored" : "synthetic";
+			synthetic.files = std::move(pack.files);
+			for (size_t i = 0; i < pack.top.size() && synthetic.requests.size() < args.requests; i++) {
+				synthetic.requests.push_back(crafter::Ingredients(pack.top[i], 1));
+			}
+			run_suite(synthetic, args, sink);
+		}
+	}
+
+	close(sink);
+	return 0;
+}
+
+// Runs fn args.repeat times and prints the best and mean wall time, the
+// mean allocations per run, plus hardware counter ratios over all the runs
+// with --perf. The counters are the ones perf::enable() opened for the
+// scopes, so nothing is counted without --perf
+template <typename F>
+void measure(const bench_input& input, std::string_view phase, const bench_args& args, F&& fn) {
+	double best = 0;
+	double total = 0;
+	crafter::perf::sample counted;
+	crafter::perf::clear_totals();
+	auto allocations_start = crafter::stats::allocations();
+	auto bytes_start = crafter::stats::allocated_bytes();
+	for (size_t i = 0; i < args.repeat; i++) {
+		auto counters_start = crafter::perf::read();
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		std::chrono::duration<double, std::milli> taken = std::chrono::steady_clock::now() - start;
+		counted += crafter::perf::difference(crafter::perf::read(), counters_start);
+		best = i == 0 ? taken.count() : std::min(best, taken.count());
+		total += taken.count();
+	}
+	auto allocations = crafter::stats::allocations() - allocations_start;
+	auto bytes = crafter::stats::allocated_bytes() - bytes_start;
+	std::cout << input.name << "\t" << input.recipes.size() << "\t" << phase << "\t"
+	          << best << "\t" << total / args.repeat << "\t"
+	          << allocations / args.repeat << "\t" << bytes / args.repeat;
+	if (args.perf) {
+		print_perf(counted);
+	}
+	std::cout << "\n";
+	// Stages reported by perf::Scope inside the phase
+	if (args.perf) {
+		for (const auto& stage : crafter::perf::totals()) {
+			std::cout << input.name << "\t" << input.recipes.size() << "\t" << stage.first << "\t-\t-\t-\t-";
+			print_perf(stage.second);
+			std::cout << "\n";
+		}
+	}
+}
+
+void print_perf(const crafter::perf::sample& taken) {
+	using namespace crafter::perf;
+	auto column = [](double value, double scale) {
+		std::cout << "\t";
+		if (value < 0) {
+			std::cout << "-";
+		} else {
+			std::cout << value * scale;
+		}
+	};
+	column(taken.ipc(), 1);
+	column(taken.ratio(branch_misses, branches), 100);
+	column(taken.ratio(l1d_misses, l1d_loads), 100);
+	column(taken.ratio(llc_misses, llc_loads), 100);
+}
+
+void run_suite(bench_input& input, const bench_args& args, int sink) {
+	if (!input.directory.empty()) {
+		measure(input, "import", args, [&]() { input.recipes = crafter::read_templates(input.directory); });
+	} else {
+		measure(input, "import", args, [&]() {
+			input.recipes = crafter::recipe_store();
+			for (const auto& file : input.files) {
+				std::istringstream in{file};
+				crafter::read_in(in, input.recipes);
+			}
+		});
+	}
+	if (!input.files.empty()) {
+		// YAML alone, the parser's and emitter's share of importing
+		std::vector<YAML::Node> documents;
+		measure(input, "parse", args, [&]() {
+			documents.clear();
+			for (const auto& file : input.files) {
+				documents.push_back(YAML::Load(file));
+			}
+		});
+		measure(input, "emit", args, [&]() {
+			for (const auto& document : documents) {
+				YAML::Emitter out;
+				out << document;
+			}
+		});
+	}
+	crafter::recipe_index index;
+	measure(input, "index", args, [&]() { index = crafter::recipe_index(input.recipes); });
+	recipe_graph_t recipe_graph;
+	craft_store recipe_counts;
+	craft_order order;
+	measure(input, "build_graph", args, [&]() { recipe_graph = build_graph(input.requests, index); });
+	measure(input, "tally_count", args, [&]() { recipe_counts = tally_count(input.requests, index); });
+	// Read only copy for planner threads, swapped in while they walk the
+	// previous one
+	using frozen_graph_t = graph::FrozenGraph<std::string, int>;
+	graph::Snapshot<frozen_graph_t> frozen;
+	std::atomic<size_t> walked = 0;
+	measure(input, "freeze", args, [&]() { frozen.Store(std::make_shared<const frozen_graph_t>(recipe_graph.Freeze())); });
+	measure(input, "frozen_walk", args, [&]() {
+		std::vector<std::thread> walkers;
+		for (int i = 0; i < 4; i++) {
+			walkers.emplace_back([&]() {
+				graph::Snapshot<frozen_graph_t>::Reader reader{frozen};
+				size_t edges = 0;
+				for (size_t pass = 0; pass < 100; pass++) {
+					const auto& graph = *reader.Load();
+					for (frozen_graph_t::index_t node = 0; node < graph.size(); node++) {
+						edges += graph.Connected(node).size();
+					}
+				}
+				walked += edges;
+			});
+		}
+		frozen.Store(std::make_shared<const frozen_graph_t>(recipe_graph.Freeze()));
+		for (auto& walker : walkers) {
+			walker.join();
+		}
+	});
+	measure(input, "get_order", args, [&]() { order = get_order(recipe_counts); });
+	measure(input, "output", args, [&]() { output(order, recipe_counts, recipe_graph, crafter::output_format::text, sink); });
+	// Whole request planned in one arena, released when it goes out of scope
+	measure(input, "plan_arena", args, [&]() {
+		std::pmr::monotonic_buffer_resource arena;
+		auto arena_graph = build_graph(input.requests, index, &arena);
+		auto arena_counts = tally_count(input.requests, index, &arena);
+	});
+	if (!input.files.empty()) {
+		// Import and build_graph together, parsing only the recipes the requests reach
+		measure(input, "lazy_graph", args, [&]() {
+			crafter::lazy_recipes lazy;
+			for (const auto& file : input.files) {
+				lazy.add(file);
+			}
+			auto lazy_graph = build_graph(input.requests, lazy);
+		});
+	}
+}
+
+bench_args read_args(int argc, char const *argv[]) {
+	bench_args result;
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		auto split = arg.find('=');
+		if (arg.substr(0, 2) != "--" || split == std::string_view::npos) {
+			std::cerr << "Expected --option=value arguments\n";
+			throw std::invalid_argument(argv[i]);
+		}
+		auto option = arg.substr(2, split - 2);
+		std::string value{arg.substr(split + 1)};
+		if (option == "max-items") {
+			result.max_items = std::stoull(value);
+		} else if (option == "repeat") {
+			result.repeat = std::max<size_t>(1, std::stoull(value));
+		} else if (option == "requests") {
+			result.requests = std::stoull(value);
+		} else if (option == "depth") {
+			result.synthetic.depth = std::stoull(value);
+		} else if (option == "fan-in") {
+			result.synthetic.fan_in = std::stoull(value);
+		} else if (option == "fan-out") {
+			result.synthetic.fan_out = std::stoull(value);
+		} else if (option == "max-makes") {
+			result.synthetic.max_makes = std::stoi(value);
+		} else if (option == "alternatives") {
+			result.synthetic.alternatives = std::stod(value);
+		} else if (option == "cycles") {
+			result.synthetic.cycles = std::stod(value);
+		} else if (option == "perf") {
+			result.perf = value != "0";
+		} else if (option == "shared") {
+			result.shared = std::stod(value);
+		} else if (option == "seed") {
+			result.synthetic.seed = std::stoull(value);
+		} else {
+			std::cerr << "Unknown option " << option << "\n";
+			throw std::invalid_argument(argv[i]);
+		}
+	}
+	return result;
+}
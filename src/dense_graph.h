@@ -0,0 +1,142 @@
+#pragma once
+
+#ifndef CRAFTER_DENSE_GRAPH
+#define CRAFTER_DENSE_GRAPH
+
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "graph.h"
+
+namespace graph {
+
+// Node types which are small non-negative ids. Specialise for strong id
+// types convertible to and from size_t to opt them into DenseGraph
+template <typename N>
+struct is_dense_node : std::bool_constant<std::is_integral_v<N> || std::is_enum_v<N>> {};
+
+template <>
+struct is_dense_node<bool> : std::false_type {};
+
+template <typename N, typename E>
+class DenseGraph;
+
+// Graph implementation to use for a node type
+template <typename N, typename E>
+using select_graph_t = std::conditional_t<is_dense_node<N>::value, DenseGraph<N, E>, Graph<N, E>>;
+
+template <typename N, typename E>
+std::ostream& operator<<(std::ostream& os, const DenseGraph<N, E>& graph);
+
+template <typename N, typename E>
+bool operator==(const DenseGraph<N, E>& lhs, const DenseGraph<N, E>& rhs);
+
+template <typename N, typename E>
+class _dense_const_iterator;
+
+template <typename N, typename E>
+bool operator==(const _dense_const_iterator<N, E>& lhs, const _dense_const_iterator<N, E>& rhs);
+
+template <typename N, typename E>
+bool operator!=(const _dense_const_iterator<N, E>& lhs, const _dense_const_iterator<N, E>& rhs);
+
+// Node storage for DenseGraph, edges are kept sorted by destination with
+// the weights in a parallel array
+template <typename N, typename E>
+struct DenseNodes {
+	std::vector<N> edges;
+	std::vector<E> weights;
+	std::vector<N> incoming;
+};
+
+// Graph over integral/id nodes, nodes are indexed directly into a vector
+// with membership in a bitset, so no lookup hashes anything
+template <typename N, typename E>
+class DenseGraph {
+private:
+	std::vector<DenseNodes<N, E>> nodes;
+	std::vector<uint64_t> present;
+	size_t node_count = 0;
+
+	friend std::ostream& operator<< <N, E>(std::ostream& os, const DenseGraph<N, E>&);
+	friend bool operator== <N, E>(const DenseGraph<N, E>& lhs, const DenseGraph<N, E>& rhs);
+	friend class _dense_const_iterator<N, E>;
+
+	static size_t index(N value) { return static_cast<size_t>(value); }
+	static bool negative(N value);
+	bool test(size_t i) const { return (i >> 6) < present.size() && (present[i >> 6] >> (i & 63)) & 1; }
+	size_t next_node(size_t from) const;
+public:
+	DenseGraph(typename std::vector<N>::const_iterator, typename std::vector<N>::const_iterator);
+
+	DenseGraph(typename std::vector<std::tuple<N, N, E>>::const_iterator,
+	           typename std::vector<std::tuple<N, N, E>>::const_iterator);
+
+	DenseGraph(const std::initializer_list<N>);
+	DenseGraph(const DenseGraph<N, E>&) = default;
+	DenseGraph(DenseGraph<N, E>&&) = default;
+	DenseGraph() = default;
+	~DenseGraph() = default;
+
+	void Reserve(size_t node_capacity);
+
+	bool InsertNode(N val);
+	bool InsertEdge(N src, N dst, const E& w);
+	bool DeleteNode(N);
+
+	bool IsNode(N) const;
+	bool IsConnected(N src, N dst) const;
+	size_t size() const { return node_count; }
+	std::vector<N> GetNodes() const;
+	std::vector<N> GetConnected(N) const;
+	std::vector<N> GetIncoming(N) const;
+	E GetWeight(N src, N dst) const;
+	bool erase(N src, N dst);
+	bool SetWeight(N src, N dst, const E& w);
+	bool Replace(N oldData, N newData);
+	void MergeReplace(N oldData, N newData);
+
+	// Borrowed views of a node's adjacency, valid until the graph is modified
+	std::span<const N> Connected(N) const;
+	std::span<const E> Weights(N) const;
+	std::span<const N> Incoming(N) const;
+
+	using const_iterator = _dense_const_iterator<N, E>;
+
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+	const_iterator find(N) const;
+	const_iterator begin() const;
+	const_iterator end() const;
+};
+
+template <typename N, typename E>
+class _dense_const_iterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = N;
+	using pointer = const N*;
+	using reference = N;
+	using difference_type = std::ptrdiff_t;
+
+	reference operator*() const { return static_cast<N>(pos_); }
+	_dense_const_iterator operator++();
+	_dense_const_iterator operator++(int);
+	friend bool operator== <N ,E>(const _dense_const_iterator& lhs, const _dense_const_iterator& rhs);
+	friend bool operator!= <N, E>(const _dense_const_iterator& lhs, const _dense_const_iterator& rhs);
+private:
+	const DenseGraph<N, E>* graph_;
+	size_t pos_;
+	_dense_const_iterator(const DenseGraph<N, E>* graph, size_t pos) : graph_ {graph}, pos_ {pos} {};
+	friend class DenseGraph<N, E>;
+};
+
+}
+
+#include "dense_graph.tpp"
+
+#endif /* end of include guard: CRAFTER_DENSE_GRAPH */
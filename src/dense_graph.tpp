@@ -0,0 +1,361 @@
+#include "dense_graph.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace graph {
+
+template <typename N, typename E>
+DenseGraph<N, E>::DenseGraph(typename std::vector<N>::const_iterator begin,
+                             typename std::vector<N>::const_iterator end) {
+	for (auto iter = begin; iter != end; iter++) {
+		InsertNode(*iter);
+	}
+}
+
+template <typename N, typename E>
+DenseGraph<N, E>::DenseGraph(typename std::vector<std::tuple<N, N, E>>::const_iterator begin,
+                             typename std::vector<std::tuple<N, N, E>>::const_iterator end) {
+	for (auto iter = begin; iter != end; iter++) {
+		auto [name1, name2, weight] = *iter;
+		InsertNode(name1);
+		InsertNode(name2);
+		InsertEdge(name1, name2, weight);
+	}
+}
+
+template <typename N, typename E>
+DenseGraph<N, E>::DenseGraph(const typename std::initializer_list<N> list) {
+	for (const auto& item : list) {
+		InsertNode(item);
+	}
+}
+
+template <typename N, typename E>
+void DenseGraph<N, E>::Reserve(size_t node_capacity) {
+	nodes.reserve(node_capacity);
+	present.reserve((node_capacity + 63) / 64);
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::negative(N value) {
+	if constexpr (std::is_enum_v<N>) {
+		using U = std::underlying_type_t<N>;
+		if constexpr (std::is_signed_v<U>) {
+			return static_cast<U>(value) < 0;
+		}
+	} else if constexpr (std::is_signed_v<N>) {
+		return value < 0;
+	}
+	return false;
+}
+
+template <typename N, typename E>
+size_t DenseGraph<N, E>::next_node(size_t from) const {
+	size_t word = from >> 6;
+	if (word >= present.size()) {
+		return nodes.size();
+	}
+	uint64_t bits = present[word] & (~uint64_t{0} << (from & 63));
+	while (bits == 0) {
+		if (++word == present.size()) {
+			return nodes.size();
+		}
+		bits = present[word];
+	}
+	return (word << 6) + std::countr_zero(bits);
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::InsertNode(N val) {
+	if (negative(val)) {
+		throw std::out_of_range("Cannot call DenseGraph::InsertNode with a negative node");
+	}
+	auto i = index(val);
+	if (test(i)) {
+		return false;
+	}
+	if (i >= nodes.size()) {
+		nodes.resize(i + 1);
+		present.resize((i >> 6) + 1);
+	}
+	present[i >> 6] |= uint64_t{1} << (i & 63);
+	node_count++;
+	return true;
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::InsertEdge(N src, N dst, const E& w) {
+	if (!IsNode(src) || !IsNode(dst)) {
+		throw std::runtime_error(
+		"Cannot call Graph::InsertEdge when either src or dst node does not exist");
+	}
+	auto& src_node = nodes[index(src)];
+	auto pos = std::lower_bound(src_node.edges.begin(), src_node.edges.end(), dst);
+	if (pos != src_node.edges.end() && *pos == dst) {
+		throw std::runtime_error(
+		"Cannot call Graph::InsertEdge when the edge already exists");
+	}
+	auto offset = pos - src_node.edges.begin();
+	src_node.edges.insert(pos, dst);
+	src_node.weights.insert(src_node.weights.begin() + offset, w);
+	auto& incoming = nodes[index(dst)].incoming;
+	incoming.insert(std::lower_bound(incoming.begin(), incoming.end(), src), src);
+	return true;
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::DeleteNode(N value) {
+	if (!IsNode(value)) {
+		return false;
+	}
+	auto& node = nodes[index(value)];
+	for (auto inbound : node.incoming) {
+		if (inbound == value) {
+			continue;
+		}
+		auto& src_node = nodes[index(inbound)];
+		auto pos = std::lower_bound(src_node.edges.begin(), src_node.edges.end(), value);
+		src_node.weights.erase(src_node.weights.begin() + (pos - src_node.edges.begin()));
+		src_node.edges.erase(pos);
+	}
+	for (auto outbound : node.edges) {
+		auto& incoming = nodes[index(outbound)].incoming;
+		auto pos = std::lower_bound(incoming.begin(), incoming.end(), value);
+		if (pos != incoming.end() && *pos == value) {
+			incoming.erase(pos);
+		}
+	}
+	node = DenseNodes<N, E>();
+	auto i = index(value);
+	present[i >> 6] &= ~(uint64_t{1} << (i & 63));
+	node_count--;
+	return true;
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::IsNode(N value) const {
+	return !negative(value) && test(index(value));
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::IsConnected(N src, N dst) const {
+	if (!IsNode(src) || !IsNode(dst)) {
+		throw std::runtime_error(
+		"Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+	}
+	const auto& edges = nodes[index(src)].edges;
+	return std::binary_search(edges.begin(), edges.end(), dst);
+}
+
+template <typename N, typename E>
+std::vector<N> DenseGraph<N, E>::GetNodes() const {
+	return std::vector<N>(begin(), end());
+}
+
+template <typename N, typename E>
+std::vector<N> DenseGraph<N, E>::GetConnected(N value) const {
+	auto edges = Connected(value);
+	return std::vector<N>(edges.begin(), edges.end());
+}
+
+template <typename N, typename E>
+std::vector<N> DenseGraph<N, E>::GetIncoming(N value) const {
+	auto incoming = Incoming(value);
+	return std::vector<N>(incoming.begin(), incoming.end());
+}
+
+template <typename N, typename E>
+std::span<const N> DenseGraph<N, E>::Connected(N value) const {
+	if (!IsNode(value)) {
+		throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
+	}
+	return nodes[index(value)].edges;
+}
+
+template <typename N, typename E>
+std::span<const E> DenseGraph<N, E>::Weights(N value) const {
+	if (!IsNode(value)) {
+		throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
+	}
+	return nodes[index(value)].weights;
+}
+
+template <typename N, typename E>
+std::span<const N> DenseGraph<N, E>::Incoming(N value) const {
+	if (!IsNode(value)) {
+		throw std::out_of_range("Cannot call Graph::GetIncoming if src doesn't exist in the graph");
+	}
+	return nodes[index(value)].incoming;
+}
+
+template <typename N, typename E>
+E DenseGraph<N, E>::GetWeight(N src, N dst) const {
+	if (!IsNode(src) || !IsNode(dst)) {
+		throw std::out_of_range(
+		"Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+	}
+	const auto& src_node = nodes[index(src)];
+	auto pos = std::lower_bound(src_node.edges.begin(), src_node.edges.end(), dst);
+	if (pos != src_node.edges.end() && *pos == dst) {
+		return src_node.weights[pos - src_node.edges.begin()];
+	}
+	throw std::out_of_range(
+	"Cannot call Graph::GetWeights if src or dst node aren't connected");
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::erase(N src, N dst) {
+	if (!IsNode(src) || !IsNode(dst)) {
+		return false;
+	}
+	auto& src_node = nodes[index(src)];
+	auto pos = std::lower_bound(src_node.edges.begin(), src_node.edges.end(), dst);
+	if (pos == src_node.edges.end() || *pos != dst) {
+		return false;
+	}
+	src_node.weights.erase(src_node.weights.begin() + (pos - src_node.edges.begin()));
+	src_node.edges.erase(pos);
+	auto& incoming = nodes[index(dst)].incoming;
+	incoming.erase(std::lower_bound(incoming.begin(), incoming.end(), src));
+	return true;
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::SetWeight(N src, N dst, const E& w) {
+	if (!IsNode(src) || !IsNode(dst)) {
+		throw std::runtime_error(
+		"Cannot call Graph::InsertEdge when either src or dst node does not exist");
+	}
+	auto& src_node = nodes[index(src)];
+	auto pos = std::lower_bound(src_node.edges.begin(), src_node.edges.end(), dst);
+	if (pos != src_node.edges.end() && *pos == dst) {
+		src_node.weights[pos - src_node.edges.begin()] = w;
+		return true;
+	}
+	return InsertEdge(src, dst, w);
+}
+
+template <typename N, typename E>
+bool DenseGraph<N, E>::Replace(N oldData, N newData) {
+	if (!IsNode(oldData)) {
+		throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
+	}
+	if (IsNode(newData)) {
+		throw std::runtime_error("Cannot call Graph::Replace on a node that already exists");
+	}
+	InsertNode(newData);
+
+	MergeReplace(oldData, newData);
+	return true;
+}
+
+template <typename N, typename E>
+void DenseGraph<N, E>::MergeReplace(N oldData, N newData) {
+	if (!IsNode(oldData) || !IsNode(newData)) {
+		throw std::runtime_error(
+		"Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
+	}
+
+	// InsertEdge can shift the old node's arrays, so work from a copy
+	auto old_node = nodes[index(oldData)];
+
+	for (size_t i = 0; i < old_node.edges.size(); i++) {
+		if (old_node.edges[i] == oldData) {
+			InsertEdge(newData, newData, old_node.weights[i]);
+		} else {
+			InsertEdge(newData, old_node.edges[i], old_node.weights[i]);
+		}
+	}
+
+	for (const auto incoming : old_node.incoming) {
+		if (incoming != oldData) {
+			InsertEdge(incoming, newData, GetWeight(incoming, oldData));
+		}
+	}
+
+	DeleteNode(oldData);
+}
+
+template <typename N, typename E>
+std::ostream& operator<<(std::ostream& os, const DenseGraph<N, E>& graph) {
+	for (const auto value : graph) {
+		const auto& node = graph.nodes[DenseGraph<N, E>::index(value)];
+		os << value;
+		os << " (\n";
+		for (size_t i = 0; i < node.edges.size(); i++) {
+			os << "  " << node.edges[i] << " | " << node.weights[i] << "\n";
+		}
+		os << ")\n";
+	}
+	return os;
+}
+
+template <typename N, typename E>
+bool operator==(const DenseGraph<N, E>& lhs, const DenseGraph<N, E>& rhs) {
+	if (lhs.node_count != rhs.node_count) {
+		return false;
+	}
+	for (const auto value : lhs) {
+		if (!rhs.IsNode(value)) {
+			return false;
+		}
+		const auto& lhs_node = lhs.nodes[DenseGraph<N, E>::index(value)];
+		const auto& rhs_node = rhs.nodes[DenseGraph<N, E>::index(value)];
+		if (lhs_node.edges != rhs_node.edges || lhs_node.weights != rhs_node.weights) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename N, typename E>
+typename DenseGraph<N, E>::const_iterator DenseGraph<N, E>::cbegin() const {
+	return const_iterator(this, next_node(0));
+}
+
+template <typename N, typename E>
+typename DenseGraph<N, E>::const_iterator DenseGraph<N, E>::cend() const {
+	return const_iterator(this, nodes.size());
+}
+
+template <typename N, typename E>
+typename DenseGraph<N, E>::const_iterator DenseGraph<N, E>::find(N value) const {
+	return IsNode(value) ? const_iterator(this, index(value)) : cend();
+}
+
+template <typename N, typename E>
+typename DenseGraph<N, E>::const_iterator DenseGraph<N, E>::begin() const {
+	return cbegin();
+}
+
+template <typename N, typename E>
+typename DenseGraph<N, E>::const_iterator DenseGraph<N, E>::end() const {
+	return cend();
+}
+
+template <typename N, typename E>
+bool operator==(const _dense_const_iterator<N, E>& lhs, const _dense_const_iterator<N, E>& rhs) {
+	return lhs.pos_ == rhs.pos_;
+}
+
+template <typename N, typename E>
+bool operator!=(const _dense_const_iterator<N, E>& lhs, const _dense_const_iterator<N, E>& rhs) {
+	return lhs.pos_ != rhs.pos_;
+}
+
+template <typename N, typename E>
+_dense_const_iterator<N, E> _dense_const_iterator<N, E>::operator++() {
+	pos_ = graph_->next_node(pos_ + 1);
+	return *this;
+}
+
+template <typename N, typename E>
+_dense_const_iterator<N, E> _dense_const_iterator<N, E>::operator++(int) {
+	auto copy{*this};
+	pos_ = graph_->next_node(pos_ + 1);
+	return copy;
+}
+
+}
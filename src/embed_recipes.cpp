@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "import.h"
+#include "perfect_hash.h"
+
+// Writes the recipe files given on the command line out as a C++ source
+// defining crafter::embedded::recipes(), see embedded.h
+//   embed_recipes <output.cpp> <recipes.yaml>...
+
+struct string_pool {
+	std::string text;
+	std::unordered_map<std::string, size_t> offsets;
+
+	// Offset of a string in the pool, equal strings are only stored once
+	size_t add(const std::string& value) {
+		auto it = offsets.find(value);
+		if (it != offsets.end()) {
+			return it->second;
+		}
+		auto offset = text.size();
+		text += value;
+		offsets.emplace(value, offset);
+		return offset;
+	}
+};
+
+std::string string_ref(string_pool& pool, const std::string& value);
+void write_pool(std::ostream& os, std::string_view pool);
+
+int main(int argc, char const *argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: embed_recipes <output.cpp> <recipes.yaml>...\n";
+		return 1;
+	}
+	crafter::recipe_store recipes;
+	for (int i = 2; i < argc; i++) {
+		std::ifstream file{argv[i]};
+		if (!file) {
+			std::cerr << "Failed to open " << argv[i] << "\n";
+			return 1;
+		}
+		crafter::read_in(file, recipes);
+	}
+
+	std::vector<std::string_view> names;
+	names.reserve(recipes.size());
+	for (const auto& recipe : recipes) {
+		names.push_back(recipe.first);
+	}
+	// Raw materials get entries without recipes, so they have IDs in the
+	// index as well
+	for (const auto& recipe : recipes) {
+		for (const auto& alternative : recipe.second) {
+			for (const auto& ingredient : alternative.ingredients) {
+				if (crafter::lookup(recipes, ingredient.name) == recipes.end()) {
+					names.push_back(ingredient.name);
+				}
+			}
+		}
+	}
+	// Sorted first so the output only depends on the recipes
+	std::sort(names.begin(), names.end());
+	names.erase(std::unique(names.begin(), names.end()), names.end());
+	auto index = crafter::build_perfect_hash(names);
+	std::vector<std::string_view> slots(names.size());
+	for (const auto& name : names) {
+		slots[index.slot(name)] = name;
+	}
+
+	string_pool pool;
+	std::string entries;
+	std::string recipe_table;
+	std::string ingredient_table;
+	size_t recipe_count = 0;
+	size_t ingredient_count = 0;
+	const std::vector<crafter::Recipe> raw;
+	for (const auto& name : slots) {
+		auto found = crafter::lookup(recipes, name);
+		const auto& alternatives = found != recipes.end() ? found->second : raw;
+		entries += "\t\t{" + string_ref(pool, std::string(name)) + ", " + std::to_string(recipe_count) + ", "
+		           + std::to_string(alternatives.size()) + "},\n";
+		for (const auto& recipe : alternatives) {
+			recipe_table += "\t\t{" + std::to_string(recipe.makes) + ", " + std::to_string(ingredient_count) + ", "
+			                + std::to_string(recipe.ingredients.size()) + "},\n";
+			for (const auto& ingredient : recipe.ingredients) {
+				ingredient_table += "\t\t{" + string_ref(pool, ingredient.name) + ", " + std::to_string(ingredient.count) + "},\n";
+			}
+			ingredient_count += recipe.ingredients.size();
+			recipe_count++;
+		}
+	}
+
+	std::string displacements;
+	for (auto displacement : index.displacements) {
+		displacements += "\t\t" + std::to_string(displacement) + ",\n";
+	}
+
+	std::ofstream out{argv[1]};
+	out << "// Generated by embed_recipes, do not edit\n"
+	    << "#include <array>\n\n"
+	    << "#include \"embedded.h\"\n\n"
+	    << "namespace crafter::embedded {\n"
+	    << "namespace {\n"
+	    << "\tconstexpr char pool[] =\n";
+	write_pool(out, pool.text);
+	out << "\tconstexpr std::array<entry_ref, " << slots.size() << "> entries{{\n" << entries << "\t}};\n"
+	    << "\tconstexpr std::array<recipe_ref, " << recipe_count << "> recipe_table{{\n" << recipe_table << "\t}};\n"
+	    << "\tconstexpr std::array<ingredient_ref, " << ingredient_count << "> ingredient_table{{\n" << ingredient_table << "\t}};\n"
+	    << "\tconstexpr std::array<uint32_t, " << index.displacements.size() << "> displacements{{\n" << displacements << "\t}};\n"
+	    << "\tconstexpr database embedded{\n"
+	    << "\t\tstd::string_view(pool, sizeof(pool) - 1), entries, recipe_table, ingredient_table,\n"
+	    << "\t\t" << index.seed << "u, displacements};\n"
+	    << "}\n\n"
+	    << "const database& recipes() {\n"
+	    << "\treturn embedded;\n"
+	    << "}\n"
+	    << "}\n";
+	if (!out) {
+		std::cerr << "Failed to write " << argv[1] << "\n";
+		return 1;
+	}
+	return 0;
+}
+
+std::string string_ref(string_pool& pool, const std::string& value) {
+	return "{" + std::to_string(pool.add(value)) + ", " + std::to_string(value.size()) + "}";
+}
+
+// Octal escapes for anything outside printable ASCII, since they never
+// run on into the next character
+void write_pool(std::ostream& os, std::string_view pool) {
+	constexpr size_t line_length = 100;
+	os << "\t\t\"";
+	size_t column = 0;
+	for (unsigned char c : pool) {
+		if (column >= line_length) {
+			os << "\"\n\t\t\"";
+			column = 0;
+		}
+		if (c == '"' || c == '\\') {
+			os << '\\' << c;
+		} else if (c >= 0x20 && c < 0x7f && c != '?') {
+			os << c;
+		} else {
+			os << '\\' << static_cast<char>('0' + (c >> 6)) << static_cast<char>('0' + ((c >> 3) & 7))
+			   << static_cast<char>('0' + (c & 7));
+		}
+		column++;
+	}
+	os << "\";\n";
+}
@@ -0,0 +1,49 @@
+#include "embedded.h"
+
+#include <string>
+#include <vector>
+
+namespace crafter::embedded {
+	std::vector<std::vector<Recipe>> load() {
+		const auto& db = recipes();
+		std::vector<std::vector<Recipe>> result;
+		result.reserve(db.entries.size());
+		for (const auto& entry : db.entries) {
+			std::string name{db.text(entry.name)};
+			auto& alternatives = result.emplace_back();
+			alternatives.reserve(entry.recipe_count);
+			for (const auto& recipe : db.recipes.subspan(entry.first_recipe, entry.recipe_count)) {
+				std::vector<Ingredients> ingredients;
+				ingredients.reserve(recipe.ingredient_count);
+				for (const auto& ingredient : db.ingredients.subspan(recipe.first_ingredient, recipe.ingredient_count)) {
+					ingredients.emplace_back(std::string(db.text(ingredient.name)), ingredient.count);
+				}
+				alternatives.push_back(Recipe(name, recipe.makes, std::move(ingredients)));
+			}
+		}
+		return result;
+	}
+
+	std::vector<std::string_view> names() {
+		const auto& db = recipes();
+		std::vector<std::string_view> result;
+		result.reserve(db.entries.size());
+		for (const auto& entry : db.entries) {
+			if (entry.recipe_count != 0) {
+				result.push_back(db.text(entry.name));
+			}
+		}
+		return result;
+	}
+
+	recipe_index index(std::span<const std::vector<Recipe>> recipes) {
+		const auto& db = embedded::recipes();
+		perfect_hash hash{db.seed, std::vector<uint32_t>(db.displacements.begin(), db.displacements.end()), db.entries.size()};
+		std::vector<std::string_view> slots;
+		slots.reserve(db.entries.size());
+		for (const auto& entry : db.entries) {
+			slots.push_back(db.text(entry.name));
+		}
+		return recipe_index(std::move(hash), slots, recipes);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "import.h"
+#include "perfect_hash.h"
+#include "recipe_index.h"
+
+// Recipe database compiled into the binary by the embedded_recipes rule.
+// Strings live in one pool, and entries are stored in perfect hash slot
+// order so recipes are indexed without touching the filesystem or any YAML
+namespace crafter::embedded {
+	struct string_ref {
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	struct ingredient_ref {
+		string_ref name;
+		int count;
+	};
+
+	struct recipe_ref {
+		int makes;
+		uint32_t first_ingredient;
+		uint32_t ingredient_count;
+	};
+
+	// All the recipes for one name, alternatives in load order. Raw
+	// materials have an entry with no recipes
+	struct entry_ref {
+		string_ref name;
+		uint32_t first_recipe;
+		uint32_t recipe_count;
+	};
+
+	struct database {
+		std::string_view pool;
+		std::span<const entry_ref> entries;
+		std::span<const recipe_ref> recipes;
+		std::span<const ingredient_ref> ingredients;
+		uint64_t seed;
+		std::span<const uint32_t> displacements;
+
+		constexpr std::string_view text(string_ref ref) const { return pool.substr(ref.offset, ref.size); }
+	};
+
+	// Defined in the generated source
+	const database& recipes();
+
+	// Copies the recipes out for the planner, in slot order, with no
+	// recipes for raw materials
+	std::vector<std::vector<Recipe>> load();
+	// Every recipe name in slot order, pointing into the pool. Raw materials
+	// are left out
+	std::vector<std::string_view> names();
+	// Index over load()'s result using the generated perfect hash, so no
+	// hash is built at startup
+	recipe_index index(std::span<const std::vector<Recipe>> recipes);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef CRAFTER_FROZEN_GRAPH
+#define CRAFTER_FROZEN_GRAPH
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "graph.h"
+
+namespace graph {
+
+// Immutable, contiguous copy of a Graph. Nodes are sorted by value and
+// edges stored CSR style, so a FrozenGraph can be read from any number of
+// threads at once without synchronisation. Nodes are indexed by index_t,
+// freezing a graph with npos or more nodes throws std::length_error
+template <typename N, typename E>
+class FrozenGraph {
+public:
+	using index_t = uint32_t;
+	static constexpr index_t npos = static_cast<index_t>(-1);
+
+	FrozenGraph() = default;
+	explicit FrozenGraph(const Graph<N, E>&);
+
+	size_t size() const { return values.size(); }
+	size_t edge_count() const { return edge_dst.size(); }
+
+	// Index of a node, npos if it isn't in the graph
+	index_t index(node_view<N>) const;
+	const N& value(index_t i) const { return values[i]; }
+
+	std::span<const index_t> Connected(index_t i) const;
+	std::span<const E> Weights(index_t i) const;
+	std::span<const index_t> Incoming(index_t i) const;
+
+	bool IsNode(node_view<N>) const;
+	bool IsConnected(node_view<N> src, node_view<N> dst) const;
+	std::vector<N> GetNodes() const { return values; }
+	std::vector<N> GetConnected(node_view<N>) const;
+	std::vector<N> GetIncoming(node_view<N>) const;
+	E GetWeight(node_view<N> src, node_view<N> dst) const;
+
+	typename std::vector<N>::const_iterator begin() const { return values.cbegin(); }
+	typename std::vector<N>::const_iterator end() const { return values.cend(); }
+
+private:
+	std::vector<N> values;
+	std::vector<size_t> edge_offsets;
+	std::vector<index_t> edge_dst;
+	std::vector<E> edge_weight;
+	std::vector<size_t> incoming_offsets;
+	std::vector<index_t> incoming_src;
+
+	index_t checked_index(node_view<N>, const char* error) const;
+};
+
+// Holder for the current snapshot of some immutable data, swapped RCU
+// style: writers Store() a new snapshot, and the old one is freed once the
+// last reader drops it. Each reader thread keeps a Reader, which caches a
+// snapshot and checks an atomic generation count before each use. That
+// check is the whole hot path, it only takes the writers' lock to pick up
+// a snapshot stored since the last one
+template <typename T>
+class Snapshot {
+public:
+	class Reader {
+	public:
+		explicit Reader(const Snapshot& source) : source{&source} {}
+
+		// The latest snapshot, kept alive until a later Load() sees a newer
+		// one or the reader goes away
+		const std::shared_ptr<const T>& Load();
+
+	private:
+		const Snapshot* source;
+		uint64_t generation = 0;
+		std::shared_ptr<const T> cached;
+	};
+
+	Snapshot() = default;
+	explicit Snapshot(std::shared_ptr<const T> value) : current{std::move(value)} {}
+	Snapshot(const Snapshot&) = delete;
+	Snapshot& operator=(const Snapshot&) = delete;
+
+	// Copies the current snapshot under the lock, for the odd read outside
+	// a Reader
+	std::shared_ptr<const T> Load() const;
+	void Store(std::shared_ptr<const T> value);
+	std::shared_ptr<const T> Exchange(std::shared_ptr<const T> value);
+
+private:
+	mutable std::mutex mutex;
+	std::shared_ptr<const T> current;
+	// Bumped by every store, starting at 1 so a new Reader always loads
+	std::atomic<uint64_t> generation{1};
+};
+
+}
+
+#include "frozen_graph.tpp"
+
+#endif /* end of include guard: CRAFTER_FROZEN_GRAPH */
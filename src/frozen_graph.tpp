@@ -0,0 +1,170 @@
+#include "frozen_graph.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace graph {
+
+template <typename N, typename E>
+FrozenGraph<N, E>::FrozenGraph(const Graph<N, E>& graph) {
+	// Edge offsets are size_t, so only the node count is limited by index_t
+	if (graph.nodes.size() >= npos) {
+		throw std::length_error("Cannot call Graph::Freeze on a graph with more nodes than FrozenGraph can index");
+	}
+	values.reserve(graph.nodes.size());
+	for (const auto& pair : graph.nodes) {
+		values.push_back(pair.first);
+	}
+	std::sort(values.begin(), values.end());
+
+	edge_offsets.reserve(values.size() + 1);
+	edge_offsets.push_back(0);
+	std::vector<size_t> incoming_count(values.size() + 1, 0);
+	std::vector<std::pair<index_t, E>> scratch;
+	for (const auto& value : values) {
+		const auto& node = crafter::lookup(graph.nodes, value)->second;
+		scratch.clear();
+		for (const auto& edge : node.edges) {
+			scratch.emplace_back(index(edge.first), edge.second);
+		}
+		std::sort(scratch.begin(), scratch.end(),
+		          [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+		for (const auto& edge : scratch) {
+			edge_dst.push_back(edge.first);
+			edge_weight.push_back(edge.second);
+			incoming_count[edge.first + 1]++;
+		}
+		edge_offsets.push_back(edge_dst.size());
+	}
+
+	// Sources are visited in index order, so each incoming list comes out sorted
+	incoming_offsets.resize(values.size() + 1);
+	std::partial_sum(incoming_count.begin(), incoming_count.end(), incoming_offsets.begin());
+	incoming_src.resize(edge_dst.size());
+	auto fill = incoming_offsets;
+	for (index_t src = 0; src < values.size(); src++) {
+		for (auto dst : Connected(src)) {
+			incoming_src[fill[dst]++] = src;
+		}
+	}
+}
+
+template <typename N, typename E>
+typename FrozenGraph<N, E>::index_t FrozenGraph<N, E>::index(node_view<N> value) const {
+	auto it = std::lower_bound(values.begin(), values.end(), value, std::less<>());
+	if (it == values.end() || std::less<>()(value, *it)) {
+		return npos;
+	}
+	return static_cast<index_t>(it - values.begin());
+}
+
+template <typename N, typename E>
+typename FrozenGraph<N, E>::index_t FrozenGraph<N, E>::checked_index(node_view<N> value, const char* error) const {
+	auto i = index(value);
+	if (i == npos) {
+		throw std::out_of_range(error);
+	}
+	return i;
+}
+
+template <typename N, typename E>
+std::span<const typename FrozenGraph<N, E>::index_t> FrozenGraph<N, E>::Connected(index_t i) const {
+	return {edge_dst.data() + edge_offsets[i], edge_dst.data() + edge_offsets[i + 1]};
+}
+
+template <typename N, typename E>
+std::span<const E> FrozenGraph<N, E>::Weights(index_t i) const {
+	return {edge_weight.data() + edge_offsets[i], edge_weight.data() + edge_offsets[i + 1]};
+}
+
+template <typename N, typename E>
+std::span<const typename FrozenGraph<N, E>::index_t> FrozenGraph<N, E>::Incoming(index_t i) const {
+	return {incoming_src.data() + incoming_offsets[i], incoming_src.data() + incoming_offsets[i + 1]};
+}
+
+template <typename N, typename E>
+bool FrozenGraph<N, E>::IsNode(node_view<N> value) const {
+	return index(value) != npos;
+}
+
+template <typename N, typename E>
+bool FrozenGraph<N, E>::IsConnected(node_view<N> src, node_view<N> dst) const {
+	auto src_i = index(src);
+	auto dst_i = index(dst);
+	if (src_i == npos || dst_i == npos) {
+		throw std::runtime_error(
+		"Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+	}
+	auto edges = Connected(src_i);
+	return std::binary_search(edges.begin(), edges.end(), dst_i);
+}
+
+template <typename N, typename E>
+std::vector<N> FrozenGraph<N, E>::GetConnected(node_view<N> value) const {
+	auto i = checked_index(value, "Cannot call Graph::GetConnected if src doesn't exist in the graph");
+	std::vector<N> result;
+	for (auto dst : Connected(i)) {
+		result.push_back(values[dst]);
+	}
+	return result;
+}
+
+template <typename N, typename E>
+std::vector<N> FrozenGraph<N, E>::GetIncoming(node_view<N> value) const {
+	auto i = checked_index(value, "Cannot call Graph::GetIncoming if src doesn't exist in the graph");
+	std::vector<N> result;
+	for (auto src : Incoming(i)) {
+		result.push_back(values[src]);
+	}
+	return result;
+}
+
+template <typename N, typename E>
+E FrozenGraph<N, E>::GetWeight(node_view<N> src, node_view<N> dst) const {
+	auto src_i = index(src);
+	auto dst_i = index(dst);
+	if (src_i == npos || dst_i == npos) {
+		throw std::out_of_range(
+		"Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+	}
+	auto edges = Connected(src_i);
+	auto pos = std::lower_bound(edges.begin(), edges.end(), dst_i);
+	if (pos != edges.end() && *pos == dst_i) {
+		return Weights(src_i)[pos - edges.begin()];
+	}
+	throw std::out_of_range(
+	"Cannot call Graph::GetWeights if src or dst node aren't connected");
+}
+
+template <typename T>
+const std::shared_ptr<const T>& Snapshot<T>::Reader::Load() {
+	auto latest = source->generation.load(std::memory_order_acquire);
+	if (latest != generation) {
+		// A store racing with this is picked up by the next Load()
+		cached = source->Load();
+		generation = latest;
+	}
+	return cached;
+}
+
+template <typename T>
+std::shared_ptr<const T> Snapshot<T>::Load() const {
+	std::lock_guard lock{mutex};
+	return current;
+}
+
+template <typename T>
+void Snapshot<T>::Store(std::shared_ptr<const T> value) {
+	Exchange(std::move(value));
+}
+
+template <typename T>
+std::shared_ptr<const T> Snapshot<T>::Exchange(std::shared_ptr<const T> value) {
+	std::lock_guard lock{mutex};
+	std::swap(current, value);
+	generation.fetch_add(1, std::memory_order_release);
+	return value;
+}
+
+}
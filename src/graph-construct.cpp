@@ -1,256 +1,264 @@
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
-#include <deque>
-#include <math.h>
-#include <algorithm>
-
-#if __GNUC__ > 7
-#include <filesystem>
-namespace fs = std::filesystem;
-#else
-#include <experimental/filesystem>
-namespace fs = std::experimental::filesystem;
-#define old_fs
-#endif
-
 
 #include "import.h"
 #include "graph.h"
+#include "lazy_recipes.h"
+#include "plan.h"
+#include "name_trie.h"
+#include "planner.h"
+#include "recipe_index.h"
+#include "output.h"
+#include "stats.h"
+#ifdef CRAFTER_EMBEDDED
+#include "embedded.h"
+#endif
 
 #define data_location "data/recipes/"
 
-struct craft_count {
-	size_t count = 0;
-	size_t needed = 0;
-	bool ready = false;
-	size_t distance = 0;
+std::vector<crafter::Ingredients> get_requests (const crafter::recipe_index& recipes, const crafter::name_trie& names, const std::string& input_file);
+template <typename Recipes>
+std::vector<crafter::Ingredients> get_requests_from_input (const Recipes& recipes, const crafter::name_trie& names);
+struct client_args {
+	std::string input;
+	crafter::output_format format = crafter::output_format::text;
+	bool stats = false;
+	// Input is a stream of --- separated request documents, - for stdin
+	bool batch = false;
+	// Only parse the recipes the requests reach
+	bool lazy = false;
 };
 
-using recipe_graph_t = graph::Graph<std::string, int>;
-using craft_store = std::unordered_map<std::string, craft_count>;
-graph::Graph<std::string, int> build_graph(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_store& recipes);
-craft_store tally_count(const std::vector<crafter::Ingredients>& requests, const recipe_graph_t& recipe_graph, const crafter::recipe_store& recipes);
-bool check_ingredient(const std::string& ingredient, craft_store& recipe_count, const recipe_graph_t& recipe_graph, const crafter::recipe_store& recipes);
-std::vector<crafter::Ingredients> get_requests (const crafter::recipe_store& recipes, const std::string& input_file);
-std::vector<crafter::Ingredients> get_requests_from_input (const crafter::recipe_store& recipes);
-std::vector<std::vector<std::string>> get_order (const craft_store& recipe_count);
-void output (const std::vector<std::vector<std::string>>& order, const craft_store&, const recipe_graph_t& recipe_graph);
-void output_recipe(const std::string& name, const craft_store&, const recipe_graph_t& recipe_graph);
-bool check_parent(const std::string& parent, craft_store& recipe_count, const recipe_graph_t& recipe_graph);
-crafter::recipe_store read_templates(std::string template_location);
-bool valid_extension(std::string);
-std::string read_args(int argc, char const *argv[]);
-
-
-template <typename N, typename E>
-std::vector<N> heads(graph::Graph<N, E>);
-
-template <typename N, typename E>
-std::vector<N> tails(graph::Graph<N, E>);
+client_args read_args(int argc, char const *argv[]);
+// document is the request's number in a batch, 0 outside one
+void plan(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_index& index, crafter::output_format format, size_t document = 0);
+void plan(const std::vector<crafter::Ingredients>& requests, const recipe_graph_t& recipe_graph, const crafter::recipe_index& index, crafter::output_format format, size_t document = 0);
+int run_lazy(const client_args& args);
+int run_batch(const client_args& args, const crafter::recipe_index& index, const crafter::name_trie& names);
 
 
 int main(int argc, char const *argv[]) {
-	auto input = read_args(argc, argv);
+	auto args = read_args(argc, argv);
+	const auto& input = args.input;
+	crafter::stats::enable_from_env();
+	if (args.stats) {
+		crafter::stats::enable();
+	}
+#ifndef CRAFTER_EMBEDDED
+	if (args.lazy) {
+		auto result = run_lazy(args);
+		crafter::stats::report(std::cerr);
+		return result;
+	}
+#endif
 
-	auto recipes = read_templates(data_location);
+#ifdef CRAFTER_EMBEDDED
+	// Recipes come out in the generated hash's slot order, so the index is
+	// laid over them without building another hash
+	std::vector<std::vector<crafter::Recipe>> recipes;
+	{
+		crafter::stats::Phase phase{"load"};
+		recipes = crafter::embedded::load();
+	}
+	// Raw materials have slots too, without recipes
+	auto recipe_count = static_cast<size_t>(std::count_if(recipes.begin(), recipes.end(), [](const auto& alternatives) { return !alternatives.empty(); }));
+	crafter::stats::counter("recipes", recipe_count);
+	crafter::recipe_index index;
+	crafter::name_trie names;
+	{
+		crafter::stats::Phase phase{"index"};
+		index = crafter::embedded::index(recipes);
+		names = crafter::name_trie(crafter::embedded::names());
+	}
+#else
+	crafter::recipe_store recipes;
+	{
+		crafter::stats::Phase phase{"load"};
+		recipes = crafter::read_templates(data_location);
+	}
+	auto recipe_count = recipes.size();
+	crafter::stats::counter("recipes", recipe_count);
+	crafter::recipe_index index;
+	crafter::name_trie names;
+	{
+		crafter::stats::Phase phase{"index"};
+		index = crafter::recipe_index(recipes);
+		auto recipe_names = crafter::recipe_names(recipes);
+		names = crafter::name_trie(recipe_names);
+	}
+#endif
+
+	if (args.batch) {
+		auto result = run_batch(args, index, names);
+		crafter::stats::report(std::cerr);
+		return result;
+	}
 
 	if (input == "") {
-		std::cout << "Loaded " << recipes.size() << " recipes\n";
+		std::cout << "Loaded " << recipe_count << " recipes\n";
 	}
 
-	auto requests = get_requests(recipes, input);
+	std::vector<crafter::Ingredients> requests;
+	{
+		crafter::stats::Phase phase{"requests"};
+		requests = get_requests(index, names, input);
+	}
+	crafter::stats::counter("requests", requests.size());
 
     if (requests.size() == 0) {
         std::cout << "No input given\n";
+        crafter::stats::report(std::cerr);
         return 0;
     }
 
-	auto recipe_graph = build_graph(requests, recipes);
-	// std::cout << recipe_graph;
-	auto recipe_counts = tally_count(requests, recipe_graph, recipes);
-	auto simplified = get_order(recipe_counts);
-	output(simplified, recipe_counts, recipe_graph);
+	plan(requests, index, args.format);
 
+	crafter::stats::report(std::cerr);
 	return 0;
 }
 
-graph::Graph<std::string, int> build_graph(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_store& recipes) {
-	std::deque<std::string> queue;
-	std::unordered_set<std::string> seen;
-	for (const auto& request : requests) {
-		queue.push_back(request.name);
-		seen.insert(request.name);
-	}
-	graph::Graph<std::string, int> graph_;
-	while (!queue.empty()) {
-		auto request = queue[0];
-		queue.pop_front();
-		graph_.InsertNode(request);
-		auto recipe_it = recipes.find(request);
-		if (recipe_it != recipes.end()) {
-			auto& recipe = recipe_it->second[0];
-			for (const auto& ingredient : recipe.ingredients) {
-				graph_.InsertNode(ingredient.name);
-				graph_.InsertEdge(request, ingredient.name, ingredient.count);
-				if (!seen.count(ingredient.name)) {
-					seen.insert(ingredient.name);
-					queue.push_back(ingredient.name);
-				}
-			}
-		}
+void plan(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_index& index, crafter::output_format format, size_t document) {
+	recipe_graph_t recipe_graph;
+	{
+		crafter::stats::Phase phase{"build_graph"};
+		recipe_graph = build_graph(requests, index);
 	}
-	return graph_;
+	plan(requests, recipe_graph, index, format, document);
 }
 
-template <typename N, typename E>
-std::vector<N> heads(graph::Graph<N, E> g) {
-	std::vector<N> result;
-	for (const auto& node : g) {
-		if (g.GetIncoming(node).size() == 0) {
-			result.push_back(node);
+void plan(const std::vector<crafter::Ingredients>& requests, const recipe_graph_t& recipe_graph, const crafter::recipe_index& index, crafter::output_format format, size_t document) {
+	if (crafter::stats::enabled()) {
+		size_t edges = 0;
+		for (const auto& node : recipe_graph) {
+			edges += recipe_graph.GetEdges(node).size();
 		}
+		crafter::stats::counter("nodes", recipe_graph.size());
+		crafter::stats::counter("edges", edges);
 	}
-	return result;
-}
-
-template <typename N, typename E>
-std::vector<N> tails(graph::Graph<N, E> g) {
-	std::vector<N> result;
-	for (const auto& node : g) {
-		if (g.GetConnected(node).size() == 0) {
-			result.push_back(node);
-		}
+	// std::cout << recipe_graph;
+	craft_store recipe_counts;
+	{
+		crafter::stats::Phase phase{"tally_count"};
+		recipe_counts = tally_count(requests, index);
 	}
-	return result;
-}
-
-
-craft_store tally_count(const std::vector<crafter::Ingredients>& requests, const recipe_graph_t& recipe_graph, const crafter::recipe_store& recipes) {
-	std::unordered_map<std::string, craft_count> recipe_count;
-	std::deque<std::string> queue;
-    const auto head_vec = heads(recipe_graph);
-    std::unordered_set<std::string> head_set{head_vec.begin(), head_vec.end()};
-	for (const auto& node : requests) {
-		auto needed = static_cast<size_t>(node.count);
-		auto& recipe = recipes.find(node.name)->second[0];
-		auto count = (size_t) ceil(needed / (double) recipe.makes);
-        if (head_set.count(node.name)) {
-            recipe_count[node.name] = craft_count{count, needed, true, 0};    
-        } else {
-            recipe_count[node.name] = craft_count{count, needed, false, 0};    
-        }
-		queue.push_back(node.name);
+	craft_order simplified;
+	{
+		crafter::stats::Phase phase{"get_order"};
+		simplified = get_order(recipe_counts);
 	}
-	while (!queue.empty()) {
-		auto request = queue[0];
-		queue.pop_front();
-		for (const auto& ingredient : recipe_graph.GetConnected(request)) {
-			auto ready = check_ingredient(ingredient, recipe_count, recipe_graph, recipes);
-			if (ready) {
-				queue.push_back(ingredient);
-			}
-		}
+	crafter::stats::counter("levels", simplified.size());
+	{
+		crafter::stats::Phase phase{"output"};
+		output(simplified, recipe_counts, recipe_graph, format, 1, document);
 	}
+}
 
-	std::vector<size_t> distances;
-	for (const auto& tail : tails(recipe_graph)) {
-		distances.push_back(recipe_count[tail].distance);
+// Indexes the recipe files without parsing them, then parses only the
+// recipes the requests reach. index covers just those
+int run_lazy(const client_args& args) {
+	crafter::lazy_recipes recipes;
+	{
+		crafter::stats::Phase phase{"load"};
+		for (const auto& file : crafter::template_files(data_location)) {
+			recipes.add_file(file);
+		}
 	}
-
-	size_t max_distance = *std::max_element(distances.cbegin(), distances.cend());
-
-	for (auto& it : recipe_count) {
-		it.second.ready = false;
+	crafter::stats::counter("recipes", recipes.size());
+	crafter::name_trie names;
+	{
+		crafter::stats::Phase phase{"index"};
+		names = crafter::name_trie(recipes.names());
 	}
-
-	for (const auto& tail : tails(recipe_graph)) {
-		queue.push_back(tail);
-		recipe_count[tail].distance = max_distance;
-		recipe_count[tail].ready = true;
+	if (args.input == "") {
+		std::cout << "Indexed " << recipes.size() << " recipes\n";
 	}
 
-	while (!queue.empty()) {
-		auto request = queue[0];
-		queue.pop_front();
-		for (const auto& parent : recipe_graph.GetIncoming(request)) {
-			auto ready = check_parent(parent, recipe_count, recipe_graph);
-			if (ready) {
-				queue.push_back(parent);
-			}
+	std::vector<crafter::Ingredients> requests;
+	{
+		crafter::stats::Phase phase{"requests"};
+		if (args.input == "") {
+			requests = get_requests_from_input(recipes, names);
+		} else {
+			requests = crafter::get_requests_from_file(recipes, args.input, &names);
 		}
 	}
+	crafter::stats::counter("requests", requests.size());
+	if (requests.size() == 0) {
+		std::cout << "No input given\n";
+		return 0;
+	}
 
-	return recipe_count;
+	recipe_graph_t recipe_graph;
+	{
+		crafter::stats::Phase phase{"build_graph"};
+		recipe_graph = build_graph(requests, recipes);
+	}
+	crafter::stats::counter("parsed", recipes.loaded().size());
+	crafter::recipe_index index{recipes.loaded()};
+	plan(requests, recipe_graph, index, args.format);
+	return 0;
 }
 
-bool check_ingredient(const std::string& ingredient, craft_store& recipe_count, const recipe_graph_t& recipe_graph, const crafter::recipe_store& recipes) {
-	craft_count count;
-	if (recipe_count.count(ingredient) != 0) {
-        count = recipe_count[ingredient];
-        if (count.ready) {
-            return true;
-        }
-	}
-	decltype(count.distance) parent_distance = 0;
-	for (const auto& parent : recipe_graph.GetIncoming(ingredient)) {
-		if (!recipe_count[parent].ready) {
-			return false;
+// Plans each document as it arrives, the stream parses the next one meanwhile
+int run_batch(const client_args& args, const crafter::recipe_index& index, const crafter::name_trie& names) {
+	std::ifstream file;
+	if (args.input != "" && args.input != "-") {
+		file.open(args.input);
+		if (!file) {
+			std::cerr << "Failed to open " << args.input << "\n";
+			return 1;
 		}
-		count.needed += recipe_count[parent].count * recipe_graph.GetWeight(parent, ingredient);
-		parent_distance = std::max(parent_distance, recipe_count[parent].distance);
 	}
-	count.distance = parent_distance + 1;
-	auto recipe_it = recipes.find(ingredient);
-	bool has_recipe = recipe_it != recipes.end();
-	if (!has_recipe) {
-		count.ready = true;
-		count.count = count.needed;
-	} else {
-		auto& recipe = recipe_it->second[0];
-		count.count = ceil(count.needed / (double) recipe.makes);
-		count.ready = true;
-	}
-	recipe_count[ingredient] = count;
-	return has_recipe;
-}
-
-bool check_parent(const std::string& parent, craft_store& recipe_count, const recipe_graph_t& recipe_graph) {
-	size_t child_distance = -1;
-	for (const auto& child : recipe_graph.GetConnected(parent)) {
-		if (!recipe_count[child].ready) {
-			return false;
+	crafter::request_stream stream{file.is_open() ? file : std::cin, index, &names};
+	std::vector<crafter::Ingredients> requests;
+	size_t documents = 0;
+	// One header for the stream, each record carries its document number
+	output_header(args.format, true);
+	while (stream.next(requests)) {
+		documents++;
+		if (requests.size() == 0) {
+			std::cerr << "No requests in document " << documents << "\n";
+			continue;
+		}
+		if (args.format == crafter::output_format::text) {
+			std::cout << "=============== Request " << documents << " ===============\n\n";
 		}
-		child_distance = std::min(child_distance, recipe_count[child].distance);
+		plan(requests, index, args.format, documents);
 	}
-	recipe_count[parent].distance = child_distance - 1;
-	recipe_count[parent].ready = true;
-	return true;
+	crafter::stats::counter("documents", documents);
+	return 0;
 }
 
-std::vector<crafter::Ingredients> get_requests (const crafter::recipe_store& recipes, const std::string& input_file) {
+std::vector<crafter::Ingredients> get_requests (const crafter::recipe_index& recipes, const crafter::name_trie& names, const std::string& input_file) {
 	if (input_file == "") {
-		return get_requests_from_input(recipes);
+		return get_requests_from_input(recipes, names);
 	} else {
-		return crafter::get_requests_from_file(recipes, input_file);
+		return crafter::get_requests_from_file(recipes, input_file, &names);
 	}
 }
 
 
-std::vector<crafter::Ingredients> get_requests_from_input (const crafter::recipe_store& recipes) {
+// A prefix of exactly one recipe name is completed to that recipe
+template <typename Recipes>
+std::vector<crafter::Ingredients> get_requests_from_input (const Recipes& recipes, const crafter::name_trie& names) {
 	std::cout << "Input Recipe: ";
 	std::string in;
 	getline(std::cin, in);
 
 	std::vector<crafter::Ingredients> requests;
 	while (in != "") {
-		auto it = recipes.find(in);
-		if (it == recipes.end()) {
-			std::cerr << "Recipe not found\n";
-		} else {
+		if (crafter::has_recipe(recipes, in)) {
 			requests.push_back(crafter::Ingredients(in, 1));
+		} else if (auto completions = names.complete(in, 2); completions.size() == 1) {
+			std::cerr << "Completed to " << completions[0].name << "\n";
+			requests.push_back(crafter::Ingredients(std::string(completions[0].name), 1));
+		} else {
+			std::cerr << "Recipe not found\n";
+			crafter::print_suggestions(std::cerr, names, in);
 		}
 		std::cout << "Input Recipe: ";
 		getline(std::cin, in);
@@ -259,82 +267,44 @@ std::vector<crafter::Ingredients> get_requests_from_input (const crafter::recipe
 	return requests;
 }
 
-std::vector<std::vector<std::string>> get_order (const craft_store& recipe_count) {
-	std::vector<std::vector<std::string>> result;
-	for (const auto& it : recipe_count) {
-		auto& name = it.first;
-		auto& craft = it.second;
-		if (craft.distance >= result.size()) {
-			result.resize(craft.distance + 1);
-		}
-		result[craft.distance].push_back(name);
-	}
-	for (auto& level : result) {
-		std::sort(level.begin(), level.end());
-	}
-	return result;
-}
-
-void output (const std::vector<std::vector<std::string>>& order, const craft_store& craft, const recipe_graph_t& recipe_graph) {
-	const std::string line = "---------------";
-	size_t level_count = 0;
-	for (auto level = order.crbegin(); level != order.crend(); level++) {
-		level_count++;
-		std::cout << line << " " << "Level " << level_count << " " << line << "\n\n";
-		for (const auto& name : *level) {
-			output_recipe(name, craft, recipe_graph);
-		}
-	}
-}
 
-void output_recipe(const std::string& name, const craft_store& craft, const recipe_graph_t& recipe_graph) {
-	std::cout << name << " (" << craft.find(name)->second.count << ")\n";
-	size_t count = craft.find(name)->second.count;
-	for (const auto& ingredient : recipe_graph.GetConnected(name)) {
-		std::cout << count * recipe_graph.GetWeight(name, ingredient) << "\t" << ingredient << "\n";
-	}
-	if (recipe_graph.GetConnected(name).size() != 0) {
-		std::cout << "\n";
-	}
-}
 
-bool valid_extension(std::string extension) {
-	if (extension == ".yaml" || extension == ".yml") {
-		return true;
-	}
-	return false;
-}
-
-#ifndef old_fs
-crafter::recipe_store read_templates(std::string template_location) {
-	crafter::recipe_store result;
-	for (const auto& entry : fs::directory_iterator(template_location)) {
-		if (entry.is_regular_file() && valid_extension(entry.path().extension())) {
-			crafter::read_in(entry.path(), result);
+client_args read_args (int argc, char const *argv[]) {
+	constexpr std::string_view format_flag = "--format=";
+	client_args result;
+	size_t positional = 0;
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		if (arg == "--stats") {
+			result.stats = true;
+		} else if (arg == "--batch") {
+			result.batch = true;
+		} else if (arg == "--lazy") {
+#ifdef CRAFTER_EMBEDDED
+			// Embedded recipes are already parsed, there's nothing to put off
+			std::cerr << "--lazy isn't supported with embedded recipes\n";
+			throw std::invalid_argument(argv[i]);
+#endif
+			result.lazy = true;
+		} else if (arg.substr(0, format_flag.size()) == format_flag) {
+			auto format = crafter::parse_format(arg.substr(format_flag.size()));
+			if (!format) {
+				std::cerr << "Unknown output format, expected text, jsonl, csv or binary\n";
+				throw std::invalid_argument(argv[i]);
+			}
+			result.format = *format;
+		} else if (positional++ == 0) {
+			result.input = argv[i];
+		} else {
+			std::cerr << "Got " << positional << " input files, expected 0 or 1\n";
+			throw std::invalid_argument(argv[i]);
 		}
 	}
-	return result;
-}
-#else
-crafter::recipe_store read_templates(std::string template_location) {
-	crafter::recipe_store result;
-	for (const auto& entry : fs::directory_iterator(template_location)) {
-		if (fs::is_regular_file(entry) && valid_extension(entry.path().extension())) {
-			crafter::read_in(entry.path(), result);
-		}
+	// Batches plan against the whole index, lazy recipes only hold what
+	// one request reached
+	if (result.lazy && result.batch) {
+		std::cerr << "--lazy and --batch can't be used together\n";
+		throw std::invalid_argument("--lazy");
 	}
 	return result;
 }
-#endif
-
-
-std::string read_args (int argc, char const *argv[]) {
-	if (argc == 1) {
-		return "";
-	} else if (argc == 2) {
-		return argv[1];
-	} else {
-		std::cerr << "Got " << argc << " arguements, expected 0 or 1\n";
-		throw std::invalid_argument(argv[2]);
-	}
-}
@@ -1,6 +1,13 @@
 #include "graph.h"
+#include "dense_graph.h"
+#include "testing.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace test {
 // Forward declare both templates:
@@ -56,6 +63,332 @@ bool operator==(const _G3<T, V> lhs, const _G3<T, V> rhs) {
 	return lhs.a == rhs.a && lhs.b == rhs.b;
 }
 
+namespace checks {
+using crafter::testing::check;
+using crafter::testing::throws;
+
+template <typename G>
+std::vector<int> sorted_nodes(const G& g) {
+	std::vector<int> result;
+	for (auto node : g) {
+		result.push_back(node);
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+// Same nodes, and each node has the same edges, weights and incoming nodes
+bool same_graph(const graph::Graph<int, int>& g, const graph::DenseGraph<int, int>& d) {
+	auto nodes = sorted_nodes(g);
+	if (nodes != sorted_nodes(d) || g.size() != d.size()) {
+		return false;
+	}
+	for (auto node : nodes) {
+		auto connected = g.GetConnected(node);
+		auto incoming = g.GetIncoming(node);
+		std::sort(connected.begin(), connected.end());
+		std::sort(incoming.begin(), incoming.end());
+		if (connected != d.GetConnected(node) || incoming != d.GetIncoming(node)) {
+			return false;
+		}
+		for (auto dst : connected) {
+			if (g.GetWeight(node, dst) != d.GetWeight(node, dst) || !d.IsConnected(node, dst)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Random operations on both graphs, which have to agree on every result
+// and on the graph afterwards
+bool dense_matches_graph(std::mt19937& rng) {
+	graph::Graph<int, int> g;
+	graph::DenseGraph<int, int> d;
+	auto node = [&]() { return static_cast<int>(rng() % 24); };
+	for (int step = 0; step < 2000; step++) {
+		auto a = node();
+		auto b = node();
+		auto w = static_cast<int>(rng() % 9) - 4;
+		bool same = true;
+		switch (rng() % 7) {
+		case 0:
+		case 1:
+			same = g.InsertNode(a) == d.InsertNode(a);
+			break;
+		case 2:
+		case 3:
+			same = throws([&]() { g.InsertEdge(a, b, w); }) == throws([&]() { d.InsertEdge(a, b, w); });
+			break;
+		case 4:
+			same = g.DeleteNode(a) == d.DeleteNode(a);
+			break;
+		case 5:
+			same = g.erase(a, b) == d.erase(a, b);
+			break;
+		case 6:
+			if (g.IsNode(a) && !g.IsNode(b)) {
+				same = g.Replace(a, b) == d.Replace(a, b);
+			} else {
+				same = throws([&]() { g.SetWeight(a, b, w); }) == throws([&]() { d.SetWeight(a, b, w); });
+			}
+			break;
+		}
+		if (!same || !same_graph(g, d)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Spans and iteration see the same graph as the copying accessors
+void dense_views() {
+	graph::DenseGraph<unsigned, int> d{3, 1, 200, 64};
+	d.InsertEdge(3, 200, 5);
+	d.InsertEdge(3, 1, 2);
+	d.InsertEdge(64, 3, 1);
+	auto connected = d.Connected(3);
+	auto weights = d.Weights(3);
+	check(connected.size() == 2 && connected[0] == 1 && connected[1] == 200, "Connected is sorted");
+	check(weights.size() == 2 && weights[0] == 2 && weights[1] == 5, "Weights follow Connected");
+	check(d.Incoming(3).size() == 1 && d.Incoming(3)[0] == 64, "Incoming");
+	std::vector<unsigned> nodes(d.begin(), d.end());
+	check(nodes == std::vector<unsigned>{1, 3, 64, 200}, "Iteration skips missing ids across words");
+	check(d.find(2) == d.end() && *d.find(64) == 64, "find");
+	check(throws([&]() { graph::DenseGraph<int, int>{}.InsertNode(-1); }), "Negative nodes are rejected");
+}
+
+// Same nodes and the same weighted edges, walked without the fingerprint
+bool same_structure(const graph::Graph<int, int>& lhs, const graph::Graph<int, int>& rhs) {
+	auto nodes = sorted_nodes(lhs);
+	if (nodes != sorted_nodes(rhs)) {
+		return false;
+	}
+	for (auto node : nodes) {
+		auto connected = lhs.GetConnected(node);
+		auto other = rhs.GetConnected(node);
+		std::sort(connected.begin(), connected.end());
+		std::sort(other.begin(), other.end());
+		if (connected != other) {
+			return false;
+		}
+		for (auto dst : connected) {
+			if (lhs.GetWeight(node, dst) != rhs.GetWeight(node, dst)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Fresh copy built by inserting every node and edge once
+graph::Graph<int, int> rebuild(const graph::Graph<int, int>& g) {
+	graph::Graph<int, int> result;
+	for (auto node : g) {
+		result.InsertNode(node);
+	}
+	for (auto node : g) {
+		for (auto dst : g.Connected(node)) {
+			result.InsertEdge(node, dst, g.GetWeight(node, dst));
+		}
+	}
+	return result;
+}
+
+// Connected and Incoming borrow the graph's own sets and agree with the
+// copying getters
+void graph_views() {
+	graph::Graph<std::string, int> g{"a", "b", "c"};
+	g.InsertEdge("a", "b", 1);
+	g.InsertEdge("a", "c", 2);
+	g.InsertEdge("c", "b", 3);
+	std::vector<std::string> connected;
+	for (const auto& dst : g.Connected("a")) {
+		connected.push_back(dst);
+	}
+	std::sort(connected.begin(), connected.end());
+	check(connected == std::vector<std::string>{"b", "c"}, "Connected lists outgoing nodes");
+	check(&*g.Connected("a").begin() == &g.GetEdges("a").begin()->first, "Connected borrows the edge map");
+	check(&g.Incoming("b") == &g.Incoming("b") && g.Incoming("b").size() == 2 && g.Incoming("b").count("c") == 1,
+	      "Incoming borrows the incoming set");
+	auto incoming = g.GetIncoming("b");
+	std::sort(incoming.begin(), incoming.end());
+	check(incoming == std::vector<std::string>{"a", "c"}, "GetIncoming copies Incoming");
+	check(std::ranges::empty(g.Connected("b")) && g.Incoming("a").empty(), "Views of nodes without edges are empty");
+	check(throws([&]() { g.Connected("d"); }) && throws([&]() { g.Incoming("d"); }), "Views reject missing nodes");
+}
+
+// After any sequence of edits the fingerprint matches that of a graph
+// built directly, so == agrees with a full structural walk
+bool fingerprint_upkeep(std::mt19937& rng) {
+	graph::Graph<int, int> g;
+	bool same = true;
+	for (int i = 0; i < 400 && same; i++) {
+		int a = static_cast<int>(rng() % 24), b = static_cast<int>(rng() % 24), w = static_cast<int>(rng() % 5);
+		switch (rng() % 7) {
+		case 0:
+		case 1:
+			g.InsertNode(a);
+			break;
+		case 2:
+			if (g.IsNode(a) && g.IsNode(b)) {
+				g.SetWeight(a, b, w);
+			}
+			break;
+		case 3:
+			if (g.IsNode(a) && g.IsNode(b) && !g.IsConnected(a, b)) {
+				g.InsertEdge(a, b, w);
+			}
+			break;
+		case 4:
+			g.erase(a, b);
+			break;
+		case 5:
+			g.DeleteNode(a);
+			break;
+		case 6:
+			if (g.find(a) != g.end()) {
+				g.erase(g.find(a));
+			}
+			break;
+		}
+		auto fresh = rebuild(g);
+		same = g == fresh && g.Fingerprint() == fresh.Fingerprint() && same_structure(g, fresh);
+		// A perturbed copy is == only when the walk says it's the same
+		if (g.IsNode(a) && g.IsNode(b)) {
+			fresh.SetWeight(a, b, w);
+			same = same && (g == fresh) == same_structure(g, fresh);
+		}
+	}
+	return same;
+}
+
+// erase(const_iterator) removes the node and its edges and carries on
+// with the next node
+void erase_iterator() {
+	graph::Graph<int, int> g{1, 2, 3, 4, 5, 6};
+	g.InsertEdge(1, 2, 1);
+	g.InsertEdge(2, 2, 2);
+	g.InsertEdge(3, 2, 3);
+	g.InsertEdge(2, 4, 4);
+	graph::Graph<int, int> expected{g};
+	for (auto it = g.begin(); it != g.end();) {
+		if (*it % 2 == 0) {
+			expected.DeleteNode(*it);
+			it = g.erase(it);
+		} else {
+			++it;
+		}
+	}
+	check(sorted_nodes(g) == std::vector<int>{1, 3, 5}, "erase(const_iterator) keeps odd nodes");
+	check(g == expected && same_structure(g, expected), "erase(const_iterator) matches DeleteNode");
+	check(g.GetConnected(1).empty() && g.GetConnected(3).empty(), "erase(const_iterator) removes incoming edges");
+	check(g == rebuild(g), "erase(const_iterator) keeps the fingerprint");
+}
+
+// A frozen copy has the same adjacency as the graph it came from
+bool frozen_matches_graph(std::mt19937& rng) {
+	graph::Graph<std::string, int> g;
+	for (int i = 0; i < 200; i++) {
+		auto src = "n" + std::to_string(rng() % 60);
+		auto dst = "n" + std::to_string(rng() % 60);
+		g.InsertNode(src);
+		g.InsertNode(dst);
+		g.SetWeight(src, dst, static_cast<int>(rng() % 100));
+	}
+	g.DeleteNode("n7");
+	auto frozen = g.Freeze();
+	bool same = frozen.size() == g.size();
+	size_t edges = 0;
+	for (const auto& node : g) {
+		auto i = frozen.index(node);
+		if (i == frozen.npos || frozen.value(i) != node) {
+			same = false;
+			continue;
+		}
+		auto connected = g.GetConnected(node);
+		auto incoming = g.GetIncoming(node);
+		std::sort(connected.begin(), connected.end());
+		std::sort(incoming.begin(), incoming.end());
+		edges += connected.size();
+		// Spans are sorted by index, and indices follow node order
+		std::vector<std::string> frozen_connected, frozen_incoming;
+		for (size_t j = 0; j < frozen.Connected(i).size(); j++) {
+			auto dst = frozen.value(frozen.Connected(i)[j]);
+			frozen_connected.push_back(dst);
+			same = same && frozen.Weights(i)[j] == g.GetWeight(node, dst);
+		}
+		for (auto src : frozen.Incoming(i)) {
+			frozen_incoming.push_back(frozen.value(src));
+		}
+		same = same && connected == frozen_connected && incoming == frozen_incoming;
+		same = same && connected == frozen.GetConnected(node) && incoming == frozen.GetIncoming(node);
+	}
+	same = same && edges == frozen.edge_count() && !frozen.IsNode("n7") && frozen.index("n7") == frozen.npos;
+	return same && throws([&]() { frozen.GetWeight("n7", "n1"); });
+}
+
+void snapshot_swaps() {
+	graph::Graph<std::string, int> g{"a", "b"};
+	g.InsertEdge("a", "b", 3);
+	graph::Snapshot<graph::FrozenGraph<std::string, int>> current{std::make_shared<const graph::FrozenGraph<std::string, int>>(g.Freeze())};
+	auto held = current.Load();
+	g.SetWeight("a", "b", 4);
+	auto old = current.Exchange(std::make_shared<const graph::FrozenGraph<std::string, int>>(g.Freeze()));
+	check(held == old && held->GetWeight("a", "b") == 3, "Readers keep the snapshot they loaded");
+	check(current.Load()->GetWeight("a", "b") == 4, "Load sees the stored snapshot");
+	graph::Snapshot<graph::FrozenGraph<std::string, int>>::Reader reader{current};
+	auto& cached = reader.Load();
+	check(cached->GetWeight("a", "b") == 4 && &reader.Load() == &cached && reader.Load() == cached, "Readers keep their snapshot until a store");
+	current.Store(std::make_shared<const graph::FrozenGraph<std::string, int>>(graph::Graph<std::string, int>{"c"}.Freeze()));
+	check(reader.Load()->IsNode("c") && !reader.Load()->IsNode("a"), "Readers pick up a stored snapshot");
+}
+
+// Readers on several threads while a writer stores new versions. Version v
+// has an edge a -> b of weight v and a node named after v, so a reader
+// sees a torn or freed snapshot as a mismatch, and versions never go back
+bool snapshot_threads() {
+	auto version = [](int v) {
+		graph::Graph<std::string, int> g{"a", "b", "v" + std::to_string(v)};
+		g.InsertEdge("a", "b", v);
+		return std::make_shared<const graph::FrozenGraph<std::string, int>>(g.Freeze());
+	};
+	constexpr int versions = 500;
+	graph::Snapshot<graph::FrozenGraph<std::string, int>> current{version(0)};
+	std::atomic<bool> done = false;
+	std::atomic<bool> same = true;
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; i++) {
+		readers.emplace_back([&]() {
+			graph::Snapshot<graph::FrozenGraph<std::string, int>>::Reader reader{current};
+			int seen = 0;
+			bool last = false;
+			while (!last) {
+				last = done.load();
+				const auto& snapshot = reader.Load();
+				auto v = snapshot->GetWeight("a", "b");
+				if (v < seen || !snapshot->IsNode("v" + std::to_string(v)) || snapshot->size() != 3) {
+					same = false;
+				}
+				seen = v;
+			}
+			// Stores had all finished before the last pass
+			if (seen != versions) {
+				same = false;
+			}
+		});
+	}
+	for (int v = 1; v <= versions; v++) {
+		current.Store(version(v));
+	}
+	done = true;
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	return same;
+}
+}
+
 int main() {
 	graph::Graph<std::string, int> b, c;
 	b.InsertNode("ho");
@@ -86,5 +419,14 @@ int main() {
 	a.v = 9999;
 	a.w = "testing";
 	std::cout << a;
-	return 0;
+
+	crafter::testing::check_seeds(20, "DenseGraph matches Graph", checks::dense_matches_graph);
+	checks::dense_views();
+	crafter::testing::check_seeds(10, "Fingerprint is kept up to date", checks::fingerprint_upkeep);
+	checks::erase_iterator();
+	checks::graph_views();
+	crafter::testing::check_seeds(5, "FrozenGraph matches Graph", checks::frozen_matches_graph);
+	checks::snapshot_swaps();
+	crafter::testing::check(checks::snapshot_threads(), "Snapshot readers see whole versions in order");
+	return crafter::testing::result();
 }
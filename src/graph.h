@@ -3,38 +3,90 @@
 #ifndef CRAFTER_GRAPH
 #define CRAFTER_GRAPH
 
+#include <cstdint>
 #include <initializer_list>
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <set>
 #include <unordered_set>
 #include <vector>
 #include <iterator>
+#include <ranges>
 #include <iostream>
 
+#include "hash.h"
+
 namespace graph {
 
+// Hashing and lookup key for a node type, string nodes can be probed
+// with anything convertible to std::string_view
+template <typename N>
+struct node_traits {
+	using hash = std::hash<N>;
+	using equal = std::equal_to<N>;
+	using view = const N&;
+};
+
+template <>
+struct node_traits<std::string> {
+	using hash = crafter::string_hash;
+	using equal = crafter::string_equal;
+	using view = std::string_view;
+};
+
+template <>
+struct node_traits<std::pmr::string> : node_traits<std::string> {};
+
+template <typename N>
+using node_view = typename node_traits<N>::view;
+
+// Containers take a std::pmr resource, so a whole graph can be built in an
+// arena and released at once. They use the default heap otherwise
+using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+template <typename N>
+using node_set = std::pmr::unordered_set<N, typename node_traits<N>::hash, typename node_traits<N>::equal>;
+
 template <typename N, typename E>
 struct Nodes;
 
 template <typename N, typename E>
-using edge_map = std::unordered_map<N, E> ;
+using edge_map = std::pmr::unordered_map<N, E, typename node_traits<N>::hash, typename node_traits<N>::equal>;
 
 template <typename N, typename E>
-using node_map = std::unordered_map<N, Nodes<N, E>>;
+using node_map = std::pmr::unordered_map<N, Nodes<N, E>, typename node_traits<N>::hash, typename node_traits<N>::equal>;
 
 template <typename N, typename E>
 struct Nodes {
+	using allocator_type = graph::allocator_type;
+
+	Nodes() = default;
+	Nodes(const Nodes&) = default;
+	Nodes(Nodes&&) = default;
+	explicit Nodes(const allocator_type& alloc)
+		: edges{alloc}, value{std::make_obj_using_allocator<N>(alloc)}, incoming{alloc} {}
+	Nodes(const Nodes& other, const allocator_type& alloc)
+		: edges{other.edges, alloc}, value{std::make_obj_using_allocator<N>(alloc, other.value)}, incoming{other.incoming, alloc} {}
+	Nodes(Nodes&& other, const allocator_type& alloc)
+		: edges{std::move(other.edges), alloc}, value{std::make_obj_using_allocator<N>(alloc, std::move(other.value))}, incoming{std::move(other.incoming), alloc} {}
+	Nodes& operator=(const Nodes&) = default;
+	Nodes& operator=(Nodes&&) = default;
+
 	edge_map<N, E> edges;
 	N value;
-	std::unordered_set<N> incoming;
+	node_set<N> incoming;
 	bool operator<(const struct Nodes& other) { return value < other.value; }
 };
 
 template <typename N, typename E>
 class Graph;
 
+template <typename N, typename E>
+class FrozenGraph;
+
 template <typename N, typename E>
 std::ostream& operator<<(std::ostream& os, const Graph<N, E>& graph);
 
@@ -54,46 +106,74 @@ template <typename N, typename E>
 class Graph {
 private:
 	node_map<N, E> nodes;
+	uint64_t fingerprint = 0;
 
 	friend std::ostream& operator<< <N, E>(std::ostream& os, const Graph<N, E>&);
 	friend bool operator== <N, E>(const Graph<N, E>& lhs, const Graph<N, E>& rhs);
+	friend class FrozenGraph<N, E>;
 
-	static bool node_check(const Graph<N, E>& lhs, const Graph<N, E>& rhs);
-	static bool edge_check(const Graph<N, E>& lhs, const Graph<N, E>& rhs);
+	static bool structure_check(const Graph<N, E>& lhs, const Graph<N, E>& rhs);
+	static uint64_t node_hash(node_view<N>);
+	static uint64_t edge_hash(node_view<N> src, node_view<N> dst, const E& w);
+
+	typename node_map<N, E>::iterator find_node(node_view<N>);
+	typename node_map<N, E>::const_iterator find_node(node_view<N>) const;
+	// Removes a node and every edge to or from it, returns the next node
+	typename node_map<N, E>::iterator erase_node(typename node_map<N, E>::const_iterator);
 public:
 	Graph(typename std::vector<N>::const_iterator, typename std::vector<N>::const_iterator);
 
-	Graph<N, E>(typename std::vector<std::tuple<N, N, E>>::const_iterator,
-	            typename std::vector<std::tuple<N, N, E>>::const_iterator);
+	Graph(typename std::vector<std::tuple<N, N, E>>::const_iterator,
+	      typename std::vector<std::tuple<N, N, E>>::const_iterator);
 
-	Graph<N, E>(const std::initializer_list<N>);
-	Graph<N, E>(const Graph<N, E>&);
-	Graph<N, E>(Graph<N, E>&&);
+	Graph(const std::initializer_list<N>);
+	explicit Graph(const allocator_type& alloc) : nodes{alloc} {}
+	Graph(const Graph<N, E>&);
+	Graph(const Graph<N, E>&, const allocator_type&);
+	Graph(Graph<N, E>&&);
+	Graph& operator=(const Graph<N, E>&) = default;
+	Graph& operator=(Graph<N, E>&&);
 	Graph() = default;
 	~Graph() = default;
 
-	bool InsertNode(const N& val);
-	bool InsertEdge(const N& src, const N& dst, const E& w);
-	bool DeleteNode(const N&);
-
-	bool IsNode(const N&) const;
-	bool IsConnected(const N& src, const N& dst) const;
+	bool InsertNode(node_view<N> val);
+	bool InsertEdge(node_view<N> src, node_view<N> dst, const E& w);
+	bool DeleteNode(node_view<N>);
+
+	bool IsNode(node_view<N>) const;
+	size_t size() const { return nodes.size(); }
+	allocator_type get_allocator() const { return nodes.get_allocator(); }
+	// Order independent hash of the nodes and weighted edges, equal graphs
+	// always have equal fingerprints
+	uint64_t Fingerprint() const { return fingerprint; }
+	bool IsConnected(node_view<N> src, node_view<N> dst) const;
 	std::vector<N> GetNodes() const;
-	std::vector<N> GetConnected(const N&) const;
-	std::vector<N> GetIncoming(const N&) const;
-	E GetWeight(const N& src, const N& dst) const;
-	bool erase(const N& src, const N& dst);
-	bool SetWeight(const N& src, const N& dst, const E& w);
+	std::vector<N> GetConnected(node_view<N>) const;
+	std::vector<N> GetIncoming(node_view<N>) const;
+	// Outgoing edges with their weights, valid until the graph is modified
+	const edge_map<N, E>& GetEdges(node_view<N>) const;
+	// Borrowed forms of GetConnected and GetIncoming, which copy nothing
+	// and are likewise valid until the graph is modified
+	using connected_view = std::ranges::keys_view<std::ranges::ref_view<const edge_map<N, E>>>;
+	connected_view Connected(node_view<N>) const;
+	const node_set<N>& Incoming(node_view<N>) const;
+	E GetWeight(node_view<N> src, node_view<N> dst) const;
+	bool erase(node_view<N> src, node_view<N> dst);
+	bool SetWeight(node_view<N> src, node_view<N> dst, const E& w);
 	bool Replace(const N& oldData, const N& newData);
-	void MergeReplace(const N& oldData, const N& newData);
+	void MergeReplace(node_view<N> oldData, node_view<N> newData);
+
+	// Immutable copy which is safe to share between threads
+	FrozenGraph<N, E> Freeze() const;
 
 	using const_iterator = _const_iterator<N, E>;
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 	const_iterator cbegin() const;
 	const_iterator cend() const;
+	// Same as DeleteNode, returns the iterator after the erased node
 	const_iterator erase(const_iterator it);
-	const_iterator find(const N&) const;
+	const_iterator find(node_view<N>) const;
 	const_reverse_iterator crbegin() const;
 	const_reverse_iterator crend() const;
 	const_reverse_iterator rbegin() const;
@@ -128,5 +208,6 @@ private:
 }
 
 #include "graph.tpp"
+#include "frozen_graph.h"
 
 #endif /* end of include guard: graph2 */
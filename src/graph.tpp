@@ -29,19 +29,57 @@ Graph<N, E>::Graph(const typename std::initializer_list<N> list) {
 }
 
 template <typename N, typename E>
-Graph<N, E>::Graph(const Graph<N, E>& other) : nodes{other.nodes} {}
+Graph<N, E>::Graph(const Graph<N, E>& other) : nodes{other.nodes}, fingerprint{other.fingerprint} {}
 
 template <typename N, typename E>
-Graph<N, E>::Graph(Graph<N, E>&& other) {
+Graph<N, E>::Graph(const Graph<N, E>& other, const allocator_type& alloc)
+	: nodes{other.nodes, alloc}, fingerprint{other.fingerprint} {}
+
+// The moved from graph keeps its memory resource
+template <typename N, typename E>
+Graph<N, E>::Graph(Graph<N, E>&& other) : nodes{std::move(other.nodes)}, fingerprint{other.fingerprint} {
+	other.nodes.clear();
+	other.fingerprint = 0;
+}
+
+template <typename N, typename E>
+Graph<N, E>& Graph<N, E>::operator=(Graph<N, E>&& other) {
 	nodes = std::move(other.nodes);
-	other.nodes = decltype(other.nodes)();
+	fingerprint = other.fingerprint;
+	other.nodes.clear();
+	other.fingerprint = 0;
+	return *this;
+}
+
+template <typename N, typename E>
+uint64_t Graph<N, E>::node_hash(node_view<N> value) {
+	return crafter::mix_hash(typename node_traits<N>::hash{}(value));
+}
+
+template <typename N, typename E>
+uint64_t Graph<N, E>::edge_hash(node_view<N> src, node_view<N> dst, const E& w) {
+	auto src_hash = typename node_traits<N>::hash{}(src);
+	auto dst_hash = typename node_traits<N>::hash{}(dst);
+	return crafter::mix_hash(crafter::mix_hash(src_hash) ^ (dst_hash * 0x9e3779b97f4a7c15) ^ crafter::mix_hash(std::hash<E>{}(w) + 1));
+}
+
+template <typename N, typename E>
+typename node_map<N, E>::iterator Graph<N, E>::find_node(node_view<N> value) {
+	return crafter::lookup(nodes, value);
+}
+
+template <typename N, typename E>
+typename node_map<N, E>::const_iterator Graph<N, E>::find_node(node_view<N> value) const {
+	return crafter::lookup(nodes, value);
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::InsertNode(const N& val) {
-	if (nodes.count(val) == 0) {
-		nodes[val] = Nodes<N, E>();
-                nodes[val].value = val;
+bool Graph<N, E>::InsertNode(node_view<N> val) {
+	if (find_node(val) == nodes.end()) {
+		N key{val};
+		auto& node = nodes[key];
+		node.value = std::move(key);
+		fingerprint += node_hash(val);
 		return true;
 	} else {
 		return false;
@@ -49,18 +87,21 @@ bool Graph<N, E>::InsertNode(const N& val) {
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
-	if (!IsNode(src) || !IsNode(dst)) {
+bool Graph<N, E>::InsertEdge(node_view<N> src, node_view<N> dst, const E& w) {
+	auto src_it = find_node(src);
+	auto dst_it = find_node(dst);
+	if (src_it == nodes.end() || dst_it == nodes.end()) {
 		throw std::runtime_error(
 		"Cannot call Graph::InsertEdge when either src or dst node does not exist");
 	}
-	auto& src_node = nodes.find(src)->second;
-	auto& dest_node = nodes.find(dst)->second;
+	auto& src_node = src_it->second;
+	auto& dest_node = dst_it->second;
 
 	auto& src_edges = src_node.edges;
-	if (src_edges.count(dst) == 0) {
-		src_edges[dst] = w;
-		dest_node.incoming.insert(src);
+	if (crafter::lookup(src_edges, dst) == src_edges.end()) {
+		src_edges.emplace(dest_node.value, w);
+		dest_node.incoming.insert(src_node.value);
+		fingerprint += edge_hash(src, dst, w);
 	} else {
 		throw std::runtime_error(
 		"Cannot call Graph::InsertEdge when the edge already exists");
@@ -69,27 +110,41 @@ bool Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::DeleteNode(const N& value) {
-	if (!IsNode(value)) {
+bool Graph<N, E>::DeleteNode(node_view<N> value) {
+	auto node_it = find_node(value);
+	if (node_it == nodes.end()) {
 		return false;
 	} else {
-		auto& node = nodes[value];
-		for (auto& inbound : node.incoming) {
-			auto& src_node = nodes[inbound];
-			src_node.edges.erase(src_node);
-		}
-		for (auto& outbound : node.edges) {
-			auto& dst_node = nodes[outbound];
-			dst_node.incoming.erase(value);
-		}
-		nodes.erase(value);
+		erase_node(node_it);
 		return true;
 	}
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::IsNode(const N& value) const {
-	auto it = nodes.find(value);
+typename node_map<N, E>::iterator Graph<N, E>::erase_node(typename node_map<N, E>::const_iterator node_it) {
+	const auto& node = node_it->second;
+	for (auto& inbound : node.incoming) {
+		// A self loop is dropped with the outbound edges below
+		if (inbound == node.value) {
+			continue;
+		}
+		auto& src_node = find_node(inbound)->second;
+		auto edge_it = src_node.edges.find(node.value);
+		fingerprint -= edge_hash(inbound, node.value, edge_it->second);
+		src_node.edges.erase(edge_it);
+	}
+	for (auto& outbound : node.edges) {
+		auto& dst_node = find_node(outbound.first)->second;
+		dst_node.incoming.erase(node.value);
+		fingerprint -= edge_hash(node.value, outbound.first, outbound.second);
+	}
+	fingerprint -= node_hash(node.value);
+	return nodes.erase(node_it);
+}
+
+template <typename N, typename E>
+bool Graph<N, E>::IsNode(node_view<N> value) const {
+	auto it = find_node(value);
 	if (it == nodes.end()) {
 		return false;
 	} else {
@@ -98,13 +153,14 @@ bool Graph<N, E>::IsNode(const N& value) const {
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::IsConnected(const N& src, const N& dst) const {
-	if (!IsNode(src) || !IsNode(dst)) {
+bool Graph<N, E>::IsConnected(node_view<N> src, node_view<N> dst) const {
+	auto src_it = find_node(src);
+	if (src_it == nodes.end() || !IsNode(dst)) {
 		throw std::runtime_error(
 		"Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
 	}
-	const auto& src_node = nodes[src];
-	if (src_node.edges.find(dst) == src_node.edges.end()) {
+	const auto& src_node = src_it->second;
+	if (crafter::lookup(src_node.edges, dst) == src_node.edges.end()) {
 		return false;
 	} else {
 		return true;
@@ -121,41 +177,67 @@ std::vector<N> Graph<N, E>::GetNodes() const {
 }
 
 template <typename N, typename E>
-std::vector<N> Graph<N, E>::GetConnected(const N& value) const {
-	auto src_it = nodes.find(value);
+std::vector<N> Graph<N, E>::GetConnected(node_view<N> value) const {
+	auto connected = Connected(value);
+	return std::vector<N>(connected.begin(), connected.end());
+}
+
+template <typename N, typename E>
+const edge_map<N, E>& Graph<N, E>::GetEdges(node_view<N> value) const {
+	auto src_it = find_node(value);
+	if (src_it == nodes.end()) {
+		throw std::out_of_range("Cannot call Graph::GetEdges if src doesn't exist in the graph");
+	}
+	return src_it->second.edges;
+}
+
+template <typename N, typename E>
+typename Graph<N, E>::connected_view Graph<N, E>::Connected(node_view<N> value) const {
+	auto src_it = find_node(value);
 	if (src_it == nodes.end()) {
 		throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
 	}
-	const auto& src = src_it->second;
-	std::vector<N> result;
-	for (const auto& pair : src.edges) {
-		result.push_back(pair.first);
+	return connected_view{std::ranges::ref_view{src_it->second.edges}};
+}
+
+template <typename N, typename E>
+const node_set<N>& Graph<N, E>::Incoming(node_view<N> node) const {
+	auto src_it = find_node(node);
+	if (src_it == nodes.end()) {
+		throw std::out_of_range("Cannot call Graph::GetIncoming if src doesn't exist in the graph");
 	}
-	return result;
+	return src_it->second.incoming;
 }
 
 template <typename N, typename E>
-E Graph<N, E>::GetWeight(const N& src, const N& dst) const {
-	if (!IsNode(src) || !IsNode(dst)) {
+E Graph<N, E>::GetWeight(node_view<N> src, node_view<N> dst) const {
+	auto src_it = find_node(src);
+	if (src_it == nodes.end() || !IsNode(dst)) {
 		throw std::out_of_range(
 		"Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
 	}
-	const auto& src_node = nodes.find(src)->second;
-	if (src_node.edges.count(dst)) {
-		return src_node.edges.find(dst)->second;
+	const auto& src_node = src_it->second;
+	auto edge_it = crafter::lookup(src_node.edges, dst);
+	if (edge_it != src_node.edges.end()) {
+		return edge_it->second;
 	}
 	throw std::out_of_range(
 	"Cannot call Graph::GetWeights if src or dst node aren't connected");
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::erase(const N& src, const N& dst) {
-	if (!IsNode(src) || !IsNode(dst)) {
+bool Graph<N, E>::erase(node_view<N> src, node_view<N> dst) {
+	auto src_it = find_node(src);
+	auto dst_it = find_node(dst);
+	if (src_it == nodes.end() || dst_it == nodes.end()) {
 		return false;
 	}
-	auto& src_node = nodes[src];
-	if (src_node.edges.count(dst)) {
-		src_node.edges.erase(dst);
+	auto& src_node = src_it->second;
+	auto edge_it = crafter::lookup(src_node.edges, dst);
+	if (edge_it != src_node.edges.end()) {
+		fingerprint -= edge_hash(src, dst, edge_it->second);
+		src_node.edges.erase(edge_it);
+		dst_it->second.incoming.erase(src_node.value);
 		return true;
 	} else {
 		return false;
@@ -163,21 +245,26 @@ bool Graph<N, E>::erase(const N& src, const N& dst) {
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::SetWeight(const N& src, const N& dst, const E& w) {
-	if (!IsNode(src) || !IsNode(dst)) {
+bool Graph<N, E>::SetWeight(node_view<N> src, node_view<N> dst, const E& w) {
+	auto src_it = find_node(src);
+	auto dst_it = find_node(dst);
+	if (src_it == nodes.end() || dst_it == nodes.end()) {
 		throw std::runtime_error(
 		"Cannot call Graph::InsertEdge when either src or dst node does not exist");
 	}
-	auto& src_node = nodes.find(src)->second;
-	auto& dest_node = nodes.find(dst)->second;
+	auto& src_node = src_it->second;
+	auto& dest_node = dst_it->second;
 
 	auto& src_edges = src_node.edges;
-	if (src_edges.count(dst) == 0) {
-		src_edges[dst] = w;
-		dest_node.incoming.insert(src);
+	auto edge_it = crafter::lookup(src_edges, dst);
+	if (edge_it == src_edges.end()) {
+		src_edges.emplace(dest_node.value, w);
+		dest_node.incoming.insert(src_node.value);
 	} else {
-		src_edges[dst] = w;
+		fingerprint -= edge_hash(src, dst, edge_it->second);
+		edge_it->second = w;
 	}
+	fingerprint += edge_hash(src, dst, w);
 	return true;
 }
 
@@ -196,46 +283,61 @@ bool Graph<N, E>::Replace(const N& oldData, const N& newData) {
 }
 
 template <typename N, typename E>
-void Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
-	if (!IsNode(oldData) || !IsNode(newData)) {
+void Graph<N, E>::MergeReplace(node_view<N> oldData, node_view<N> newData) {
+	auto old_it = find_node(oldData);
+	auto new_it = find_node(newData);
+	if (old_it == nodes.end() || new_it == nodes.end()) {
 		throw std::runtime_error(
 		"Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
 	}
 
-	auto& old_node = nodes[oldData];
+	auto& old_node = old_it->second;
+	const auto& new_value = new_it->second.value;
 
 	for (const auto& outbound : old_node.edges) {
-		if (outbound.first == oldData) {
-			InsertEdge(newData, newData, outbound.second);
+		if (outbound.first == old_node.value) {
+			InsertEdge(new_value, new_value, outbound.second);
 		} else {
-			InsertEdge(newData, outbound.first, outbound.second);
+			InsertEdge(new_value, outbound.first, outbound.second);
 		}
 	}
 
-	for (const auto incoming : old_node.incoming) {
-		auto& weight = nodes[incoming].edges[oldData];
-		InsertEdge(incoming, newData, weight);
+	for (const auto& incoming : old_node.incoming) {
+		if (incoming == old_node.value) {
+			continue;
+		}
+		const auto& weight = find_node(incoming)->second.edges.find(old_node.value)->second;
+		InsertEdge(incoming, new_value, weight);
 	}
 
-	DeleteNode(oldData);
+	DeleteNode(old_node.value);
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::node_check(const graph::Graph<N, E>& lhs, const graph::Graph<N, E>& rhs) {
-	for (const auto& it : lhs.nodes) {
-		if (!rhs.IsNode(it.first)) {
-			return false;
-		}
-	}
-	return true;
+FrozenGraph<N, E> Graph<N, E>::Freeze() const {
+	return FrozenGraph<N, E>(*this);
 }
 
 template <typename N, typename E>
-bool Graph<N, E>::edge_check(const Graph<N, E>& lhs, const Graph<N, E>& rhs) {
+bool Graph<N, E>::structure_check(const Graph<N, E>& lhs, const Graph<N, E>& rhs) {
+	if (lhs.nodes.size() != rhs.nodes.size()) {
+		return false;
+	}
+	// With equal node and edge counts, every lhs node/edge being in rhs
+	// means the reverse holds too
 	for (const auto& src_it : lhs.nodes) {
-		auto& src = src_it.second;
-		for (const auto& dst_it : src.edges) {
-			if (dst_it.second != rhs.GetWeight(src_it.first, dst_it.first)) {
+		auto rhs_it = rhs.nodes.find(src_it.first);
+		if (rhs_it == rhs.nodes.end()) {
+			return false;
+		}
+		const auto& lhs_edges = src_it.second.edges;
+		const auto& rhs_edges = rhs_it->second.edges;
+		if (lhs_edges.size() != rhs_edges.size()) {
+			return false;
+		}
+		for (const auto& dst_it : lhs_edges) {
+			auto edge_it = rhs_edges.find(dst_it.first);
+			if (edge_it == rhs_edges.end() || !(edge_it->second == dst_it.second)) {
 				return false;
 			}
 		}
@@ -261,21 +363,11 @@ std::ostream& operator<<(std::ostream& os, const Graph<N, E>& graph) {
 
 template <typename N, typename E>
 bool operator==(const Graph<N, E>& lhs, const Graph<N, E>& rhs) {
-	// Node equality
-	if (!Graph<N, E>::node_check(lhs, rhs)) {
+	// Differing fingerprints settle most comparisons without a walk
+	if (lhs.fingerprint != rhs.fingerprint) {
 		return false;
 	}
-	if (!Graph<N, E>::node_check(rhs, lhs)) {
-		return false;
-	}
-	// Edge equality
-	if (!Graph<N, E>::edge_check(lhs, rhs)) {
-		return false;
-	}
-	if (!Graph<N, E>::edge_check(rhs, lhs)) {
-		return false;
-	}
-	return true;
+	return Graph<N, E>::structure_check(lhs, rhs);
 }
 
 template <typename N, typename E>
@@ -290,12 +382,12 @@ typename Graph<N, E>::const_iterator Graph<N, E>::cend() const {
 
 template <typename N, typename E>
 typename Graph<N, E>::const_iterator Graph<N, E>::erase(typename Graph<N, E>::const_iterator it) {
-
+	return const_iterator(erase_node(it.iter_));
 }
 
 template <typename N, typename E>
-typename Graph<N, E>::const_iterator Graph<N, E>::find(const N&) const {
-
+typename Graph<N, E>::const_iterator Graph<N, E>::find(node_view<N> value) const {
+	return const_iterator(find_node(value));
 }
 
 template <typename N, typename E>
@@ -370,18 +462,9 @@ _const_iterator<N, E> _const_iterator<N, E>::operator--(int) {
 }
 
 template <typename N, typename E>
-std::vector<N> Graph<N, E>::GetIncoming(const N& node) const {
-  auto src_it = nodes.find(node);
-	if (src_it == nodes.end()) {
-		throw std::out_of_range("Cannot call Graph::GetIncoming if src doesn't exist in the graph");
-	}
-	const auto& src = src_it->second;
-	std::vector<N> result;
-	for (const auto& incoming : src.incoming) {
-		result.push_back(incoming);
-	}
-	return result;
-
+std::vector<N> Graph<N, E>::GetIncoming(node_view<N> node) const {
+	const auto& incoming = Incoming(node);
+	return std::vector<N>(incoming.begin(), incoming.end());
 }
 
-}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <unordered_map>
+
+namespace crafter {
+	// Number of string key hashes taken, reported by --stats. Only counted
+	// while count_hash_probes is set, so hashing stays free of shared
+	// writes otherwise
+	inline std::atomic<bool> count_hash_probes{false};
+	inline std::atomic<uint64_t> hash_probes{0};
+
+	// Transparent hash/equality so string keyed containers can be probed with
+	// std::string_view or const char* without building a temporary std::string
+	struct string_hash {
+		using is_transparent = void;
+		size_t operator()(std::string_view value) const {
+			if (count_hash_probes.load(std::memory_order_relaxed)) {
+				hash_probes.fetch_add(1, std::memory_order_relaxed);
+			}
+			return std::hash<std::string_view>{}(value);
+		}
+	};
+
+	struct string_equal {
+		using is_transparent = void;
+		bool operator()(std::string_view lhs, std::string_view rhs) const { return lhs == rhs; }
+	};
+
+	// splitmix64 finaliser, spreads a hash over all 64 bits so hashes can
+	// be combined by addition
+	constexpr uint64_t mix_hash(uint64_t value) {
+		value ^= value >> 30;
+		value *= 0xbf58476d1ce4e5b9;
+		value ^= value >> 27;
+		value *= 0x94d049bb133111eb;
+		value ^= value >> 31;
+		return value;
+	}
+
+	// Heterogeneous find, falling back to a key conversion on standard
+	// libraries without generic unordered lookup
+	template <typename Map, typename K>
+	auto lookup(Map& map, const K& key) -> decltype(map.end()) {
+#ifdef __cpp_lib_generic_unordered_lookup
+		return map.find(key);
+#else
+		return map.find(typename Map::key_type(key));
+#endif
+	}
+}
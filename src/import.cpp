@@ -1,12 +1,31 @@
 #include "import.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <map>
+#include <sstream>
 #include <vector>
 #include <string>
+#include <thread>
+#include <utility>
+
+#if __GNUC__ > 7
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#define old_fs
+#endif
 
 #include "yaml-cpp/yaml.h"
+#include "lazy_recipes.h"
+#include "name_trie.h"
+#include "perf.h"
+#include "recipe_index.h"
+#include "yaml_split.h"
 
 namespace crafter {
 	recipe_store read_in(std::string file_name) {
@@ -19,38 +38,155 @@ namespace crafter {
 		return read_in(fin, store);
 	}
 
-	recipe_store read_in(std::ifstream& file) {
+	recipe_store read_in(std::istream& file) {
 		recipe_store recipes;
 		read_in(file, recipes);
 		return recipes;
 	}
 
-	void read_in(std::ifstream& file, recipe_store& recipes) {
-		auto recipes_yaml = YAML::Load(file);
-		for (const auto it : recipes_yaml) {
-			std::string name;
-			try {
-				name = it.first.as<std::string>();
-			} catch (...) {
-				throw std::runtime_error("Failed to read in a recipe name\nThe yaml format seems to be stuffed");
+	namespace {
+		// Smaller chunks aren't worth the thread they're parsed on
+		constexpr size_t min_chunk_bytes = 16 * 1024;
+
+		// The recipes of a document in the order they're written
+		std::vector<Recipe> read_recipes(const YAML::Node& recipes_yaml) {
+			std::vector<Recipe> result;
+			// Views walk the document without copying Nodes and their memory holder
+			for (const auto it : YAML::NodeView(recipes_yaml)) {
+				std::string name;
+				try {
+					name = it.first.as<std::string>();
+				} catch (...) {
+					throw std::runtime_error("Failed to read in a recipe name\nThe yaml format seems to be stuffed");
+				}
+				result.push_back(Recipe(std::move(name), it.second));
+			}
+			return result;
+		}
+
+		void add_recipes(std::vector<Recipe>&& found, recipe_store& recipes) {
+			for (auto& recipe : found) {
+				auto& alternatives = recipes[recipe.name];
+				alternatives.push_back(std::move(recipe));
+			}
+		}
+
+		// A run of whole top level entries, and the entries it should hold
+		struct chunk {
+			std::string_view text;
+			size_t first;
+			size_t last;
+		};
+
+		// Runs of whole top level entries of about the same size, one per
+		// thread. Empty if the text is too small to be worth splitting
+		std::vector<chunk> split_chunks(std::string_view text, const std::vector<top_level_entry>& entries, unsigned threads) {
+			size_t count = std::min<size_t>({threads, text.size() / min_chunk_bytes, entries.size()});
+			std::vector<chunk> chunks;
+			if (count < 2) {
+				return chunks;
+			}
+			size_t begin = 0;
+			size_t first = 0;
+			size_t next = 1;
+			for (size_t i = 1; i < count; i++) {
+				auto target = text.size() * i / count;
+				while (next < entries.size() && entries[next].begin < target) {
+					next++;
+				}
+				if (next == entries.size()) {
+					break;
+				}
+				chunks.push_back(chunk{text.substr(begin, entries[next].begin - begin), first, next});
+				begin = entries[next].begin;
+				first = next;
+				next++;
+			}
+			chunks.push_back(chunk{text.substr(begin), first, entries.size()});
+			return chunks;
+		}
+
+		// Parses a chunk, throwing if it doesn't hold exactly the keys the
+		// splitter found in it. That would mean an entry ran on past a line
+		// the splitter took for a key
+		std::vector<Recipe> read_chunk(const chunk& at, const std::vector<top_level_entry>& entries) {
+			auto found = read_recipes(load_view(at.text));
+			if (found.size() != at.last - at.first) {
+				throw std::runtime_error("Chunk doesn't match its keys");
+			}
+			for (size_t i = 0; i < found.size(); i++) {
+				if (found[i].name != entries[at.first + i].key) {
+					throw std::runtime_error("Chunk doesn't match its keys");
+				}
+			}
+			return found;
+		}
+
+		// Parses the chunks concurrently, only adding to the store once every
+		// one has parsed. Each worker counts its own share for perf, since the
+		// scope around this only sees the thread waiting on them
+		bool read_in_chunks(const std::vector<chunk>& chunks, const std::vector<top_level_entry>& entries, recipe_store& recipes) {
+			std::vector<std::future<std::vector<Recipe>>> pending;
+			pending.reserve(chunks.size());
+			for (const auto& at : chunks) {
+				pending.push_back(std::async(std::launch::async, [&at, &entries]() {
+					perf::WorkerScope counted;
+					return read_chunk(at, entries);
+				}));
+			}
+			std::vector<std::vector<Recipe>> parsed;
+			bool failed = false;
+			for (auto& result : pending) {
+				try {
+					parsed.push_back(result.get());
+				} catch (...) {
+					failed = true;
+				}
 			}
-			auto recipe = it.second;
-			if (recipes.count(name) == 0) {
-				recipes[name] = std::vector<Recipe>();
+			if (failed) {
+				return false;
+			}
+			for (auto& found : parsed) {
+				add_recipes(std::move(found), recipes);
+			}
+			return true;
+		}
+	}
+
+	// Large files made of plain top level entries are parsed a chunk per
+	// thread. Anything split_top_level can't vouch for is parsed whole, as
+	// is a file with an error anywhere, so the error and its line number
+	// are reported the same as ever
+	void read_in(std::istream& file, recipe_store& recipes, unsigned threads) {
+		std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+		if (text.size() >= 2 * min_chunk_bytes && threads > 1) {
+			perf::Scope scope{"import.chunks"};
+			auto entries = split_top_level(text);
+			auto chunks = entries ? split_chunks(text, *entries, threads) : std::vector<chunk>();
+			if (!chunks.empty() && read_in_chunks(chunks, *entries, recipes)) {
+				return;
 			}
-			recipes[name].push_back(Recipe(name, recipe));
 		}
+		YAML::Node recipes_yaml;
+		{
+			perf::Scope scope{"import.parse"};
+			recipes_yaml = load_view(text);
+		}
+		perf::Scope scope{"import.recipes"};
+		add_recipes(read_recipes(recipes_yaml), recipes);
 	}
 
-	Recipe::Recipe(std::string name, YAML::Node recipe) : name{name} {
-		auto makes = recipe["makes"];
+	Recipe::Recipe(std::string name, YAML::Node recipe) : Recipe(std::move(name), YAML::NodeView(recipe)) {}
+
+	Recipe::Recipe(std::string name, YAML::NodeView recipe) : name{name} {
+		auto makes = recipe.find("makes");
 		if (makes.IsDefined() && !makes.IsScalar()) {
 			throw std::runtime_error("Failed to parse: " + name + "\n" + "Invalid 'makes' value");
 		}
 		if (makes.IsScalar()) {
 			this->makes = makes.as<int>();
 		}
-		auto ingredients = recipe["ingredients"];
+		auto ingredients = recipe.find("ingredients");
 		if (ingredients.IsDefined() && !(ingredients.IsSequence() || ingredients.IsMap())) {
 			throw std::runtime_error("Failed to parse: " + name + "\n" + "Invalid 'ingredients' value");
 		}
@@ -81,60 +217,191 @@ namespace crafter {
 
 	}
 
-	Ingredients::Ingredients(YAML::Node ingredient) {
-		this->count = ingredient["count"].as<int>();
-		this->name = ingredient["name"].as<std::string>();
+	Ingredients::Ingredients(YAML::Node ingredient) : Ingredients(YAML::NodeView(ingredient)) {}
+
+	Ingredients::Ingredients(YAML::NodeView ingredient) {
+		this->count = ingredient.find("count").as<int>();
+		this->name = ingredient.find("name").as<std::string>();
 	}
 
-	std::vector<Ingredients> get_requests_from_file(const crafter::recipe_store& recipes, const std::string& input_file) {
-		auto requests_yaml = YAML::LoadFile(input_file);
-		std::vector<Ingredients> requests;
-		if (requests_yaml.IsSequence()) {
-			for (const auto name_node : requests_yaml) {
-				std::string name;
-				try {
-					name = name_node.as<std::string>();
-				} catch (...) {
-					std::cerr << "Failed to read request from file\n";
-					continue;
+	bool has_recipe(const recipe_index& recipes, std::string_view name) {
+		return recipes.find(name) != nullptr;
+	}
+
+	bool has_recipe(const lazy_recipes& recipes, std::string_view name) {
+		return recipes.contains(name);
+	}
+
+	namespace {
+		// Prints a diagnostic with one write, so it isn't interleaved with
+		// output from another thread. where is prefixed to it
+		void report(std::string_view where, const std::string& message, const name_trie* names = nullptr, std::string_view name = "") {
+			std::ostringstream line;
+			line << where << message << "\n";
+			if (names != nullptr) {
+				std::ostringstream suggestions;
+				print_suggestions(suggestions, *names, name);
+				if (suggestions.tellp() > 0) {
+					line << where << suggestions.str();
 				}
-				if (recipes.count(name)) {
-					requests.push_back(Ingredients(name, 1));
-				} else {
-					std::cerr << "Could not find a recipe for " << name << "\n";
+			}
+			std::cerr << line.str();
+		}
+
+		template <typename Recipes>
+		std::vector<Ingredients> read_requests(const Recipes& recipes, const YAML::Node& requests_yaml, const name_trie* names, std::string_view where = "") {
+			std::vector<Ingredients> requests;
+			if (requests_yaml.IsSequence()) {
+				for (const auto name_node : requests_yaml) {
+					std::string name;
+					try {
+						name = name_node.as<std::string>();
+					} catch (...) {
+						report(where, "Failed to read request from file");
+						continue;
+					}
+					if (has_recipe(recipes, name)) {
+						requests.push_back(Ingredients(name, 1));
+					} else {
+						report(where, "Could not find a recipe for " + name, names, name);
+					}
+
 				}
+			} else if (requests_yaml.IsMap()) {
+				for (const auto request_it : requests_yaml) {
+					std::string name;
+					int count;
+					try {
+						name = request_it.first.as<std::string>();
+						count = request_it.second.as<int>();
+					} catch (...) {
+						report(where, "Failed to read request from file");
+						continue;
+					}
 
-			}
-		} else if (requests_yaml.IsMap()) {
-			for (const auto request_it : requests_yaml) {
+					if (has_recipe(recipes, name)) {
+						requests.push_back(Ingredients(name, count));
+					} else {
+						report(where, "Could not find a recipe for " + name, names, name);
+					}
+				}
+			} else if (requests_yaml.IsScalar()){
 				std::string name;
-				int count;
 				try {
-					name = request_it.first.as<std::string>();
-					count = request_it.second.as<int>();
+					name = requests_yaml.as<std::string>();
 				} catch (...) {
-					std::cerr << "Failed to read request from file\n";
-					continue;
+					report(where, "Failed to read request from file");
 				}
-
-				if (recipes.count(name)) {
-					requests.push_back(Ingredients(name, count));
-				} else {
-					std::cerr << "Could not find a recipe for " << name << "\n";
+				if (name != "" && has_recipe(recipes, name)) {
+					requests.push_back(Ingredients(name, 1));
 				}
 			}
-		} else if (requests_yaml.IsScalar()){
-			std::string name;
-			try {
-				name = requests_yaml.as<std::string>();
-			} catch (...) {
-				std::cerr << "Failed to read request from file\n";
+			return requests;
+		}
+	}
+
+	std::vector<Ingredients> get_requests_from_file(const recipe_index& recipes, const std::string& input_file, const name_trie* names) {
+		return get_requests_from_yaml(recipes, YAML::LoadFile(input_file), names);
+	}
+
+	std::vector<Ingredients> get_requests_from_file(const lazy_recipes& recipes, const std::string& input_file, const name_trie* names) {
+		return read_requests(recipes, YAML::LoadFile(input_file), names);
+	}
+
+	std::vector<Ingredients> get_requests_from_yaml(const recipe_index& recipes, const YAML::Node& requests_yaml, const name_trie* names) {
+		return read_requests(recipes, requests_yaml, names);
+	}
+
+	request_stream::request_stream(std::istream& in, const recipe_index& recipes, const name_trie* names)
+		: parser_{in}, recipes_{recipes}, names_{names} {
+		start();
+	}
+
+	bool request_stream::next(std::vector<Ingredients>& requests) {
+		if (!pending_.valid()) {
+			return false;
+		}
+		// Rethrows anything the worker threw while parsing
+		auto parsed = pending_.get();
+		if (!parsed) {
+			return false;
+		}
+		requests = std::move(*parsed);
+		start();
+		return true;
+	}
+
+	void request_stream::start() {
+		pending_ = std::async(std::launch::async, [this]() { return parse_next(); });
+	}
+
+	// Diagnostics name the document, the caller may still be planning the
+	// one before it
+	std::optional<std::vector<Ingredients>> request_stream::parse_next() {
+		YAML::Node document;
+		if (!YAML::LoadNext(parser_, document)) {
+			return std::nullopt;
+		}
+		documents_++;
+		auto where = "Document " + std::to_string(documents_) + ": ";
+		return read_requests(recipes_, document, names_, where);
+	}
+
+	std::vector<std::string_view> recipe_names(const recipe_store& recipes) {
+		std::vector<std::string_view> result;
+		result.reserve(recipes.size());
+		for (const auto& recipe : recipes) {
+			result.push_back(recipe.first);
+		}
+		return result;
+	}
+
+	void print_suggestions(std::ostream& os, const name_trie& names, std::string_view name) {
+		auto suggestions = names.suggest(name, 5);
+		if (suggestions.empty()) {
+			return;
+		}
+		os << "Did you mean: ";
+		for (size_t i = 0; i < suggestions.size(); i++) {
+			os << (i ? ", " : "") << suggestions[i].name;
+		}
+		os << "\n";
+	}
+
+	bool valid_extension(std::string extension) {
+		if (extension == ".yaml" || extension == ".yml") {
+			return true;
+		}
+		return false;
+	}
+
+#ifndef old_fs
+	std::vector<std::string> template_files(std::string template_location) {
+		std::vector<std::string> result;
+		for (const auto& entry : fs::directory_iterator(template_location)) {
+			if (entry.is_regular_file() && valid_extension(entry.path().extension())) {
+				result.push_back(entry.path());
 			}
-			if (name != "" && recipes.count(name)) {
-				requests.push_back(Ingredients(name, 1));
+		}
+		return result;
+	}
+#else
+	std::vector<std::string> template_files(std::string template_location) {
+		std::vector<std::string> result;
+		for (const auto& entry : fs::directory_iterator(template_location)) {
+			if (fs::is_regular_file(entry) && valid_extension(entry.path().extension())) {
+				result.push_back(entry.path());
 			}
 		}
-		return requests;
+		return result;
 	}
+#endif
 
+	recipe_store read_templates(std::string template_location) {
+		recipe_store result;
+		for (const auto& file : template_files(template_location)) {
+			read_in(file, result);
+		}
+		return result;
+	}
 }
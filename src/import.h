@@ -1,10 +1,17 @@
 #pragma once
 
+#include <future>
+#include <memory_resource>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <fstream>
+#include <istream>
 #include "yaml-cpp/yaml.h"
+#include "hash.h"
 
 namespace crafter {
 	struct StackType {
@@ -12,22 +19,71 @@ namespace crafter {
 	};
 	struct Ingredients {
 		Ingredients (YAML::Node);
+		Ingredients (YAML::NodeView);
 		Ingredients(std::string name_, int count_) : name{name_}, count{count_} {};
 		std::string name;
 		int count;
 	};
 	struct Recipe {
 		Recipe (std::string, YAML::Node);
+		// Borrows the document, which has to outlive the constructor
+		Recipe (std::string, YAML::NodeView);
+		Recipe(std::string name_, int makes_, std::vector<Ingredients> ingredients_)
+			: name{std::move(name_)}, makes{makes_}, ingredients{std::move(ingredients_)} {};
 		std::string name;
 		int makes = 1;
 		std::vector<Ingredients> ingredients;
 	};
 
-	using recipe_store = std::unordered_map<std::string, std::vector<Recipe>>;
-	recipe_store read_in(std::ifstream& file);
+	using recipe_store = std::pmr::unordered_map<std::string, std::vector<Recipe>, string_hash, string_equal>;
+	recipe_store read_in(std::istream& file);
 	recipe_store read_in(std::string file_name);
-	void read_in(std::ifstream& file, recipe_store& store);
+	// Large files are parsed a chunk per thread
+	void read_in(std::istream& file, recipe_store& store, unsigned threads = std::thread::hardware_concurrency());
 	void read_in(std::string file_name, recipe_store& store);
+	// Reads every .yaml/.yml file in a directory
+	recipe_store read_templates(std::string template_location);
+	// The .yaml/.yml files in a directory
+	std::vector<std::string> template_files(std::string template_location);
+	bool valid_extension(std::string);
 
-	std::vector<Ingredients> get_requests_from_file(const crafter::recipe_store& recipes, const std::string& input_file);
+	class recipe_index;
+	class lazy_recipes;
+	class name_trie;
+	// Whether a name has a recipe. The lazy_recipes one only looks at the
+	// index, so nothing is parsed
+	bool has_recipe(const recipe_index& recipes, std::string_view name);
+	bool has_recipe(const lazy_recipes& recipes, std::string_view name);
+	// Unknown names are reported with suggestions from names if it's given
+	std::vector<Ingredients> get_requests_from_file(const recipe_index& recipes, const std::string& input_file, const name_trie* names = nullptr);
+	// Checks names against the index only, no recipe is parsed
+	std::vector<Ingredients> get_requests_from_file(const lazy_recipes& recipes, const std::string& input_file, const name_trie* names = nullptr);
+	std::vector<Ingredients> get_requests_from_yaml(const recipe_index& recipes, const YAML::Node& requests_yaml, const name_trie* names = nullptr);
+
+	// Reads a stream of --- separated request documents one at a time. The
+	// next document is parsed on a worker thread while the caller plans the
+	// current one, so no more than two documents are held at once. recipes
+	// and names are read from both threads and mustn't change meanwhile
+	class request_stream {
+	public:
+		request_stream(std::istream& in, const recipe_index& recipes, const name_trie* names = nullptr);
+		request_stream(const request_stream&) = delete;
+		request_stream& operator=(const request_stream&) = delete;
+		// Requests in the next document, false at the end of the stream
+		bool next(std::vector<Ingredients>& requests);
+	private:
+		void start();
+		std::optional<std::vector<Ingredients>> parse_next();
+
+		YAML::Parser parser_;
+		const recipe_index& recipes_;
+		const name_trie* names_;
+		// Documents parsed so far, only touched by the worker
+		size_t documents_ = 0;
+		// Declared last so it's waited on before the parser goes away
+		std::future<std::optional<std::vector<Ingredients>>> pending_;
+	};
+	// Recipe names for a name_trie, borrowed from the store
+	std::vector<std::string_view> recipe_names(const recipe_store& recipes);
+	void print_suggestions(std::ostream& os, const name_trie& names, std::string_view name);
 }
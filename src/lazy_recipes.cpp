@@ -0,0 +1,88 @@
+#include "lazy_recipes.h"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "perf.h"
+#include "yaml_split.h"
+#include "yaml-cpp/yaml.h"
+
+namespace crafter {
+	void lazy_recipes::add(std::string text) {
+		perf::Scope scope{"import.index"};
+		files_.push_back(std::move(text));
+		if (index(files_.size() - 1)) {
+			return;
+		}
+		recipe_store whole;
+		std::istringstream in{files_.back()};
+		read_in(in, whole);
+		files_.pop_back();
+		for (auto& recipes : whole) {
+			auto& at = entries_[recipes.first];
+			for (auto& recipe : recipes.second) {
+				at.push_back(entry{read_in_whole, parsed_.size(), 0});
+				parsed_.push_back(std::move(recipe));
+			}
+		}
+	}
+
+	void lazy_recipes::add_file(const std::string& file_name) {
+		std::ifstream fin(file_name);
+		add(std::string(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()));
+	}
+
+	// Only commits the entries once the whole file is known to split cleanly
+	bool lazy_recipes::index(size_t file) {
+		auto found = split_top_level(files_[file]);
+		if (!found) {
+			return false;
+		}
+		for (auto& it : *found) {
+			entries_[std::move(it.key)].push_back(entry{file, it.begin, it.end});
+		}
+		return true;
+	}
+
+	const std::vector<Recipe>* lazy_recipes::find(std::string_view name) {
+		auto loaded_it = lookup(loaded_, name);
+		if (loaded_it != loaded_.end()) {
+			return &loaded_it->second;
+		}
+		auto entry_it = lookup(entries_, name);
+		if (entry_it == entries_.end()) {
+			return nullptr;
+		}
+		perf::Scope scope{"import.recipes"};
+		std::vector<Recipe> alternatives;
+		alternatives.reserve(entry_it->second.size());
+		for (const auto& at : entry_it->second) {
+			if (at.file == read_in_whole) {
+				alternatives.push_back(std::move(parsed_[at.begin]));
+			} else {
+				alternatives.push_back(parse(entry_it->first, at));
+			}
+		}
+		return &loaded_.emplace(entry_it->first, std::move(alternatives)).first->second;
+	}
+
+	Recipe lazy_recipes::parse(std::string_view name, const entry& at) const {
+		auto document = load_view(std::string_view(files_[at.file]).substr(at.begin, at.end - at.begin));
+		if (!document.IsMap() || document.size() != 1 || document.begin()->first.as<std::string>() != name) {
+			throw std::runtime_error("Failed to read in " + std::string(name) + "\nThe yaml format seems to be stuffed");
+		}
+		return Recipe(std::string(name), document.begin()->second);
+	}
+
+	std::vector<std::string_view> lazy_recipes::names() const {
+		std::vector<std::string_view> result;
+		result.reserve(entries_.size());
+		for (const auto& it : entries_) {
+			result.push_back(it.first);
+		}
+		return result;
+	}
+}
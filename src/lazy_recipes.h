@@ -0,0 +1,60 @@
+#pragma once
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "hash.h"
+#include "import.h"
+
+namespace crafter {
+	// Recipe files indexed by the byte ranges of their top level entries,
+	// so a recipe is only parsed the first time it's looked up. Files which
+	// can't be split at their top level keys, because they use anchors,
+	// tags, flow collections or several documents, are read in up front.
+	// Errors in a recipe only show up when it's looked up
+	class lazy_recipes {
+	public:
+		lazy_recipes() = default;
+		lazy_recipes(const lazy_recipes&) = delete;
+		lazy_recipes& operator=(const lazy_recipes&) = delete;
+		lazy_recipes(lazy_recipes&&) = default;
+		lazy_recipes& operator=(lazy_recipes&&) = default;
+
+		// Files added later come after earlier ones, as with read_in. Every
+		// file has to be added before the first lookup
+		void add(std::string text);
+		void add_file(const std::string& file_name);
+
+		// Number of recipe names, parsed or not
+		size_t size() const { return entries_.size(); }
+		// Whether a name has a recipe, without parsing it
+		bool contains(std::string_view name) const { return lookup(entries_, name) != entries_.end(); }
+		// Recipes for a name, parsed on the first lookup. nullptr for raw
+		// materials and unknown names
+		const std::vector<Recipe>* find(std::string_view name);
+		// Every recipe name, borrowed from the index
+		std::vector<std::string_view> names() const;
+		// The recipes parsed so far
+		const recipe_store& loaded() const { return loaded_; }
+
+	private:
+		static constexpr size_t read_in_whole = std::numeric_limits<size_t>::max();
+		struct entry {
+			// Index into files_, or read_in_whole for a recipe already read in
+			size_t file;
+			// Byte range in the file, or begin is the recipe's index in parsed_
+			size_t begin;
+			size_t end;
+		};
+		bool index(size_t file);
+		Recipe parse(std::string_view name, const entry& at) const;
+
+		std::vector<std::string> files_;
+		std::unordered_map<std::string, std::vector<entry>, string_hash, string_equal> entries_;
+		std::vector<Recipe> parsed_;
+		recipe_store loaded_;
+	};
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "name_trie.h"
+#include "testing.h"
+
+namespace {
+	using crafter::testing::check;
+
+	std::string folded(std::string_view name) {
+		std::string result;
+		for (char c : name) {
+			result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+		return result;
+	}
+
+	size_t edit_distance(std::string_view lhs, std::string_view rhs) {
+		std::vector<size_t> row(rhs.size() + 1);
+		for (size_t j = 0; j <= rhs.size(); j++) {
+			row[j] = j;
+		}
+		for (size_t i = 1; i <= lhs.size(); i++) {
+			auto diagonal = row[0];
+			row[0] = i;
+			for (size_t j = 1; j <= rhs.size(); j++) {
+				auto above = row[j];
+				row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (lhs[i - 1] != rhs[j - 1])});
+				diagonal = above;
+			}
+		}
+		return row[rhs.size()];
+	}
+
+	// Short names from a small alphabet, so prefixes and near misses are common
+	std::vector<std::string> random_names(std::mt19937& rng, size_t count) {
+		static const std::string alphabet = "abcAB ";
+		std::vector<std::string> names;
+		while (names.size() < count) {
+			std::string name;
+			auto size = 1 + rng() % 6;
+			for (size_t i = 0; i < size; i++) {
+				name += alphabet[rng() % alphabet.size()];
+			}
+			if (std::find(names.begin(), names.end(), name) == names.end()) {
+				names.push_back(name);
+			}
+		}
+		return names;
+	}
+
+	std::vector<std::string> names_of(const std::vector<crafter::suggestion>& suggestions) {
+		std::vector<std::string> result;
+		for (const auto& suggestion : suggestions) {
+			result.emplace_back(suggestion.name);
+		}
+		return result;
+	}
+
+	std::vector<std::string> sorted(std::vector<std::string> names) {
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+	// Every completion shortest first, as a scan over every name finds them,
+	// and a limit keeps the shortest
+	bool completes_like_scan(std::mt19937& rng) {
+		auto names = random_names(rng, 150);
+		std::vector<std::string_view> views(names.begin(), names.end());
+		crafter::name_trie trie{views};
+		bool same = trie.size() == names.size();
+		for (int i = 0; i < 300 && same; i++) {
+			auto query = random_names(rng, 1)[0].substr(0, 1 + rng() % 4);
+			auto completions = trie.complete(query, names.size());
+			std::vector<std::string> expected;
+			for (const auto& name : names) {
+				if (folded(name).starts_with(folded(query))) {
+					expected.push_back(name);
+				}
+			}
+			auto found = names_of(completions);
+			same = std::is_sorted(found.begin(), found.end(), [](const auto& lhs, const auto& rhs) { return lhs.size() < rhs.size(); });
+			same = same && sorted(found) == sorted(expected);
+			auto limited = trie.complete(query, 2);
+			same = same && limited.size() == std::min<size_t>(2, expected.size());
+			for (size_t j = 0; j < limited.size(); j++) {
+				same = same && limited[j].name == completions[j].name && limited[j].distance == 0;
+			}
+		}
+		return same;
+	}
+
+	// Every name within the distance closest first, with its distance, as a
+	// scan with a reference edit distance finds them
+	bool searches_like_scan(std::mt19937& rng) {
+		auto names = random_names(rng, 150);
+		std::vector<std::string_view> views(names.begin(), names.end());
+		crafter::name_trie trie{views};
+		bool same = true;
+		for (int i = 0; i < 300 && same; i++) {
+			auto query = random_names(rng, 1)[0].substr(0, 1 + rng() % 4);
+			size_t max_distance = rng() % 3;
+			auto matches = trie.search(query, max_distance, names.size());
+			std::vector<std::string> expected;
+			for (const auto& name : names) {
+				if (edit_distance(folded(name), folded(query)) <= max_distance) {
+					expected.push_back(name);
+				}
+			}
+			for (const auto& match : matches) {
+				same = same && match.distance == edit_distance(folded(match.name), folded(query));
+			}
+			same = same && std::is_sorted(matches.begin(), matches.end(), [](const auto& lhs, const auto& rhs) { return lhs.distance < rhs.distance; });
+			same = same && sorted(names_of(matches)) == sorted(expected);
+		}
+		return same;
+	}
+
+	void suggest() {
+		std::vector<std::string_view> names{"Iron Plate", "Iron Ingot", "Copper Plate", "Gear"};
+		crafter::name_trie trie{names};
+		auto completions = names_of(trie.suggest("iron", 5));
+		std::sort(completions.begin(), completions.end());
+		check(completions == std::vector<std::string>{"Iron Ingot", "Iron Plate"}, "suggest completes case insensitively");
+		auto typo = trie.suggest("Geer", 5);
+		check(typo.size() == 1 && typo[0].name == "Gear" && typo[0].distance == 1, "suggest falls back to close names");
+		check(trie.suggest("Zinc Bar", 5).empty(), "suggest finds nothing for far names");
+		check(crafter::name_trie{}.suggest("a", 5).empty(), "empty trie suggests nothing");
+	}
+}
+
+int main() {
+	crafter::testing::check_seeds(10, "complete matches a scan", completes_like_scan);
+	crafter::testing::check_seeds(10, "search matches a scan", searches_like_scan);
+	suggest();
+	return crafter::testing::result();
+}
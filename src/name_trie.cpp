@@ -0,0 +1,163 @@
+#include "name_trie.h"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <string>
+#include <tuple>
+
+namespace crafter {
+	namespace {
+		char fold(char c) {
+			return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+
+		std::string folded(std::string_view name) {
+			std::string result{name};
+			std::transform(result.begin(), result.end(), result.begin(), fold);
+			return result;
+		}
+
+		struct pending {
+			uint32_t node;
+			size_t begin;
+			size_t end;
+			size_t depth;
+		};
+	}
+
+	name_trie::name_trie(std::span<const std::string_view> names) {
+		std::vector<std::pair<std::string, std::string_view>> keys;
+		keys.reserve(names.size());
+		for (const auto& name : names) {
+			keys.emplace_back(folded(name), name);
+		}
+		std::sort(keys.begin(), keys.end());
+		names_.reserve(keys.size());
+		for (const auto& key : keys) {
+			names_.push_back(key.second);
+		}
+
+		// Breadth first, so every node's children are appended together
+		nodes_.push_back(node{'\0', 0, 0, 0, 0});
+		std::deque<pending> queue{pending{0, 0, keys.size(), 0}};
+		while (!queue.empty()) {
+			auto next = queue.front();
+			queue.pop_front();
+			auto begin = next.begin;
+			// Sorted, so the names ending here come first
+			while (begin < next.end && keys[begin].first.size() == next.depth) {
+				begin++;
+			}
+			nodes_[next.node].first_name = static_cast<uint32_t>(next.begin);
+			nodes_[next.node].name_count = static_cast<uint32_t>(begin - next.begin);
+			nodes_[next.node].first_child = static_cast<uint32_t>(nodes_.size());
+			while (begin < next.end) {
+				auto label = keys[begin].first[next.depth];
+				auto end = begin;
+				while (end < next.end && keys[end].first[next.depth] == label) {
+					end++;
+				}
+				queue.push_back(pending{static_cast<uint32_t>(nodes_.size()), begin, end, next.depth + 1});
+				nodes_.push_back(node{label, 0, 0, 0, 0});
+				nodes_[next.node].child_count++;
+				begin = end;
+			}
+		}
+	}
+
+	std::vector<suggestion> name_trie::complete(std::string_view prefix, size_t limit) const {
+		std::vector<suggestion> result;
+		if (nodes_.empty()) {
+			return result;
+		}
+		const node* current = &nodes_[0];
+		for (char c : prefix) {
+			auto children = nodes_.begin() + current->first_child;
+			auto found = std::find_if(children, children + current->child_count,
+			                          [&](const node& child) { return child.label == fold(c); });
+			if (found == children + current->child_count) {
+				return result;
+			}
+			current = &*found;
+		}
+		// Walking the subtree breadth first finds shorter names first
+		std::deque<const node*> queue{current};
+		while (!queue.empty() && result.size() < limit) {
+			auto next = queue.front();
+			queue.pop_front();
+			for (uint32_t i = 0; i < next->name_count && result.size() < limit; i++) {
+				result.push_back(suggestion{names_[next->first_name + i], 0});
+			}
+			for (uint32_t i = 0; i < next->child_count; i++) {
+				queue.push_back(&nodes_[next->first_child + i]);
+			}
+		}
+		return result;
+	}
+
+	std::vector<suggestion> name_trie::search(std::string_view query, size_t max_distance, size_t limit) const {
+		std::vector<suggestion> result;
+		if (nodes_.empty()) {
+			return result;
+		}
+		auto key = folded(query);
+		// One row of the edit distance table per trie depth
+		std::vector<size_t> rows(key.size() + 1);
+		for (size_t i = 0; i <= key.size(); i++) {
+			rows[i] = i;
+		}
+		if (key.size() <= max_distance) {
+			for (uint32_t i = 0; i < nodes_[0].name_count; i++) {
+				result.push_back(suggestion{names_[nodes_[0].first_name + i], key.size()});
+			}
+		}
+		search_children(nodes_[0], key, max_distance, 0, rows, result);
+
+		std::sort(result.begin(), result.end(), [&](const suggestion& lhs, const suggestion& rhs) {
+			auto lhs_gap = lhs.name.size() > query.size() ? lhs.name.size() - query.size() : query.size() - lhs.name.size();
+			auto rhs_gap = rhs.name.size() > query.size() ? rhs.name.size() - query.size() : query.size() - rhs.name.size();
+			return std::tie(lhs.distance, lhs_gap, lhs.name) < std::tie(rhs.distance, rhs_gap, rhs.name);
+		});
+		if (result.size() > limit) {
+			result.resize(limit);
+		}
+		return result;
+	}
+
+	void name_trie::search_children(const node& parent, std::string_view query, size_t max_distance, size_t depth,
+	                                std::vector<size_t>& rows, std::vector<suggestion>& result) const {
+		auto width = query.size() + 1;
+		rows.resize(std::max(rows.size(), (depth + 2) * width));
+		for (uint32_t c = 0; c < parent.child_count; c++) {
+			const auto& child = nodes_[parent.first_child + c];
+			const auto* above = rows.data() + depth * width;
+			auto* row = rows.data() + (depth + 1) * width;
+			row[0] = above[0] + 1;
+			auto best = row[0];
+			for (size_t i = 1; i < width; i++) {
+				auto replace = above[i - 1] + (query[i - 1] != child.label);
+				row[i] = std::min({above[i] + 1, row[i - 1] + 1, replace});
+				best = std::min(best, row[i]);
+			}
+			if (row[query.size()] <= max_distance) {
+				for (uint32_t i = 0; i < child.name_count; i++) {
+					result.push_back(suggestion{names_[child.first_name + i], row[query.size()]});
+				}
+			}
+			// Every later row is at least the smallest value in this one
+			if (best <= max_distance) {
+				search_children(child, query, max_distance, depth + 1, rows, result);
+			}
+		}
+	}
+
+	std::vector<suggestion> name_trie::suggest(std::string_view query, size_t limit) const {
+		auto result = complete(query, limit);
+		if (result.empty()) {
+			// Roughly one typo per four characters, at most two
+			result = search(query, std::min<size_t>(2, 1 + query.size() / 4), limit);
+		}
+		return result;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace crafter {
+	struct suggestion {
+		std::string_view name;
+		// Edit distance from the query, 0 for prefix completions
+		size_t distance;
+	};
+
+	// Case insensitive prefix trie over a fixed set of names, stored as one
+	// flat array with each node's children next to each other. Names are
+	// borrowed and have to outlive the trie
+	class name_trie {
+	public:
+		name_trie() = default;
+		explicit name_trie(std::span<const std::string_view> names);
+
+		size_t size() const { return names_.size(); }
+		// Names starting with prefix, shortest first
+		std::vector<suggestion> complete(std::string_view prefix, size_t limit) const;
+		// Names within max_distance edits of query, closest first
+		std::vector<suggestion> search(std::string_view query, size_t max_distance, size_t limit) const;
+		// Completions if there are any, otherwise the closest fuzzy matches
+		std::vector<suggestion> suggest(std::string_view query, size_t limit) const;
+
+	private:
+		struct node {
+			char label;
+			uint32_t first_child;
+			uint32_t child_count;
+			// Range of names_ ending at this node
+			uint32_t first_name;
+			uint32_t name_count;
+		};
+		std::vector<node> nodes_;
+		std::vector<std::string_view> names_;
+
+		void search_children(const node& parent, std::string_view query, size_t max_distance, size_t depth,
+		                     std::vector<size_t>& rows, std::vector<suggestion>& result) const;
+	};
+}
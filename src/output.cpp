@@ -0,0 +1,290 @@
+#include "output.h"
+
+#include <charconv>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "serialise.h"
+
+namespace crafter {
+	std::optional<output_format> parse_format(std::string_view name) {
+		if (name == "text") {
+			return output_format::text;
+		} else if (name == "jsonl" || name == "json") {
+			return output_format::jsonl;
+		} else if (name == "csv") {
+			return output_format::csv;
+		} else if (name == "binary") {
+			return output_format::binary;
+		}
+		return std::nullopt;
+	}
+
+	BufferedWriter::BufferedWriter(int fd, size_t capacity)
+		: fd_{fd}, capacity_{capacity}, buffer_{new char[capacity]} {}
+
+	BufferedWriter::~BufferedWriter() {
+		try {
+			flush();
+		} catch (...) {
+			std::cerr << "Failed to write output\n";
+		}
+	}
+
+	char* BufferedWriter::reserve(size_t size) {
+		if (used_ + size > capacity_) {
+			flush();
+		}
+		return buffer_.get() + used_;
+	}
+
+	void BufferedWriter::write(std::string_view text) {
+		while (text.size() > capacity_ - used_) {
+			auto part = capacity_ - used_;
+			std::memcpy(buffer_.get() + used_, text.data(), part);
+			used_ += part;
+			text.remove_prefix(part);
+			flush();
+		}
+		std::memcpy(buffer_.get() + used_, text.data(), text.size());
+		used_ += text.size();
+	}
+
+	void BufferedWriter::write(char c) {
+		*reserve(1) = c;
+		used_++;
+	}
+
+	void BufferedWriter::write(size_t number) {
+		constexpr size_t max_digits = 20;
+		auto* start = reserve(max_digits);
+		auto result = std::to_chars(start, start + max_digits, number);
+		used_ += result.ptr - start;
+	}
+
+	void BufferedWriter::flush() {
+		size_t done = 0;
+		while (done < used_) {
+			auto written = ::write(fd_, buffer_.get() + done, used_ - done);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				used_ = 0;
+				throw std::runtime_error(std::string("Failed to write output\n") + std::strerror(errno));
+			}
+			done += written;
+		}
+		used_ = 0;
+	}
+}
+
+namespace {
+	constexpr std::string_view binary_magic = "CREC";
+	constexpr uint64_t binary_version = 1;
+	// Records start with their document number
+	constexpr uint64_t binary_batch_version = 2;
+
+	void write_json_string(std::string_view text, crafter::BufferedWriter& out) {
+		constexpr std::string_view hex = "0123456789abcdef";
+		out.write('"');
+		for (auto c : text) {
+			auto byte = static_cast<unsigned char>(c);
+			if (c == '"' || c == '\\') {
+				out.write('\\');
+				out.write(c);
+			} else if (byte < 0x20) {
+				out.write("\\u00");
+				out.write(hex[byte >> 4]);
+				out.write(hex[byte & 0xf]);
+			} else {
+				out.write(c);
+			}
+		}
+		out.write('"');
+	}
+
+	void write_csv_field(std::string_view text, crafter::BufferedWriter& out) {
+		if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+			out.write(text);
+			return;
+		}
+		out.write('"');
+		for (auto c : text) {
+			if (c == '"') {
+				out.write('"');
+			}
+			out.write(c);
+		}
+		out.write('"');
+	}
+}
+
+void output_header(crafter::output_format format, bool batch, crafter::BufferedWriter& out) {
+	using crafter::output_format;
+	if (format == output_format::csv) {
+		out.write(batch ? "document,level,name,count,ingredient,quantity\n" : "level,name,count,ingredient,quantity\n");
+	} else if (format == output_format::binary) {
+		std::string scratch;
+		out.write(binary_magic);
+		serialise::Writer header{scratch};
+		header.varint(batch ? binary_batch_version : binary_version);
+		out.write(scratch);
+	}
+}
+
+void output_header(crafter::output_format format, bool batch, int fd) {
+	std::cout.flush();
+	crafter::BufferedWriter out{fd};
+	output_header(format, batch, out);
+}
+
+void output (const craft_order& order, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::output_format format, int fd, size_t document) {
+	using crafter::output_format;
+	constexpr std::string_view line = "---------------";
+	// Anything already sent to std::cout has to land before our output
+	std::cout.flush();
+	crafter::BufferedWriter out{fd};
+	std::string scratch;
+	if (document == 0) {
+		output_header(format, false, out);
+	}
+	size_t level_count = 0;
+	for (auto level = order.crbegin(); level != order.crend(); level++) {
+		level_count++;
+		if (format == output_format::text) {
+			out.write(line);
+			out.write(" Level ");
+			out.write(level_count);
+			out.write(' ');
+			out.write(line);
+			out.write("\n\n");
+		}
+		for (const auto& name : *level) {
+			switch (format) {
+			case output_format::text:
+				output_recipe(name, craft, recipe_graph, out);
+				break;
+			case output_format::jsonl:
+				output_json(document, level_count, name, craft, recipe_graph, out);
+				break;
+			case output_format::csv:
+				output_csv(document, level_count, name, craft, recipe_graph, out);
+				break;
+			case output_format::binary:
+				output_binary(document, level_count, name, craft, recipe_graph, out, scratch);
+				break;
+			}
+		}
+	}
+	out.flush();
+}
+
+void output_recipe(std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out) {
+	size_t count = crafter::lookup(craft, name)->second.count;
+	out.write(name);
+	out.write(" (");
+	out.write(count);
+	out.write(")\n");
+	const auto& edges = recipe_graph.GetEdges(name);
+	for (const auto& edge : edges) {
+		out.write(count * edge.second);
+		out.write('\t');
+		out.write(edge.first);
+		out.write('\n');
+	}
+	if (edges.size() != 0) {
+		out.write('\n');
+	}
+}
+
+// {"level":1,"name":"...","count":2,"needed":2,"ingredients":[{"name":"...","quantity":4}]}
+// with "document":N first in a batch
+void output_json(size_t document, size_t level, std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out) {
+	const auto& entry = crafter::lookup(craft, name)->second;
+	out.write('{');
+	if (document != 0) {
+		out.write("\"document\":");
+		out.write(document);
+		out.write(',');
+	}
+	out.write("\"level\":");
+	out.write(level);
+	out.write(",\"name\":");
+	write_json_string(name, out);
+	out.write(",\"count\":");
+	out.write(entry.count);
+	out.write(",\"needed\":");
+	out.write(entry.needed);
+	out.write(",\"ingredients\":[");
+	bool first = true;
+	for (const auto& edge : recipe_graph.GetEdges(name)) {
+		if (!first) {
+			out.write(',');
+		}
+		first = false;
+		out.write("{\"name\":");
+		write_json_string(edge.first, out);
+		out.write(",\"quantity\":");
+		out.write(entry.count * edge.second);
+		out.write('}');
+	}
+	out.write("]}\n");
+}
+
+// One row per ingredient, recipes without ingredients get a single row
+// with the last two fields empty. A batch starts each row with the document
+void output_csv(size_t document, size_t level, std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out) {
+	size_t count = crafter::lookup(craft, name)->second.count;
+	const auto& edges = recipe_graph.GetEdges(name);
+	auto row_start = [&]() {
+		if (document != 0) {
+			out.write(document);
+			out.write(',');
+		}
+		out.write(level);
+		out.write(',');
+		write_csv_field(name, out);
+		out.write(',');
+		out.write(count);
+		out.write(',');
+	};
+	if (edges.size() == 0) {
+		row_start();
+		out.write(",\n");
+	}
+	for (const auto& edge : edges) {
+		row_start();
+		write_csv_field(edge.first, out);
+		out.write(',');
+		out.write(count * edge.second);
+		out.write('\n');
+	}
+}
+
+// After the "CREC" magic and a version varint, each record is
+// level, name, count, needed and the ingredient count as varints/strings,
+// followed by a name and quantity per ingredient. Batches are version 2,
+// where each record starts with its document number
+void output_binary(size_t document, size_t level, std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out, std::string& scratch) {
+	const auto& entry = crafter::lookup(craft, name)->second;
+	const auto& edges = recipe_graph.GetEdges(name);
+	scratch.clear();
+	serialise::Writer record{scratch};
+	if (document != 0) {
+		record.varint(document);
+	}
+	record.varint(level);
+	serialise::codec<std::string>::write(record, name);
+	record.varint(entry.count);
+	record.varint(entry.needed);
+	record.varint(edges.size());
+	for (const auto& edge : edges) {
+		serialise::codec<std::string>::write(record, edge.first);
+		record.varint(entry.count * edge.second);
+	}
+	out.write(scratch);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "plan.h"
+
+namespace crafter {
+	// text is the human readable level listing, the others emit one record
+	// per recipe as they go so memory use doesn't grow with the plan
+	enum class output_format {text, jsonl, csv, binary};
+
+	std::optional<output_format> parse_format(std::string_view name);
+
+	// Formats into a fixed buffer and hands it to the kernel with one write
+	// per chunk, instead of going through iostream for every field
+	class BufferedWriter {
+	public:
+		explicit BufferedWriter(int fd, size_t capacity = 1 << 16);
+		BufferedWriter(const BufferedWriter&) = delete;
+		BufferedWriter& operator=(const BufferedWriter&) = delete;
+		~BufferedWriter();
+
+		void write(std::string_view text);
+		void write(char c);
+		void write(size_t number);
+		void flush();
+	private:
+		int fd_;
+		size_t capacity_;
+		size_t used_ = 0;
+		std::unique_ptr<char[]> buffer_;
+
+		char* reserve(size_t size);
+	};
+}
+
+// A single plan starts with the format's header. Plans in a batch pass
+// their document number instead, starting from 1. They get no header, as
+// output_header() writes it once for the whole stream, and every record
+// carries the document number
+void output (const craft_order& order, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::output_format format = crafter::output_format::text, int fd = 1, size_t document = 0);
+void output_header(crafter::output_format format, bool batch, crafter::BufferedWriter& out);
+void output_header(crafter::output_format format, bool batch, int fd = 1);
+void output_recipe(std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out);
+void output_json(size_t document, size_t level, std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out);
+void output_csv(size_t document, size_t level, std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out);
+void output_binary(size_t document, size_t level, std::string_view name, const craft_store& craft, const recipe_graph_t& recipe_graph, crafter::BufferedWriter& out, std::string& scratch);
@@ -0,0 +1,177 @@
+#include "perf.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+	struct event_config {
+		uint32_t type;
+		uint64_t config;
+	};
+
+	constexpr uint64_t cache_event(uint64_t cache, uint64_t result) {
+		return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+	}
+
+	constexpr std::array<event_config, crafter::perf::counter_count> events = {{
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+		{PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_ACCESS)},
+		{PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+		{PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_ACCESS)},
+		{PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+	}};
+
+	int open_event(const event_config& event) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = event.type;
+		attr.config = event.config;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	bool perf_enabled = false;
+	std::unique_ptr<crafter::perf::Counters> shared_counters;
+	std::vector<std::pair<std::string, crafter::perf::sample>> named_totals;
+	// Counted by WorkerScopes on other threads
+	std::mutex worker_mutex;
+	crafter::perf::sample worker_total;
+}
+
+namespace crafter::perf {
+	sample& sample::operator+=(const sample& other) {
+		for (size_t i = 0; i < counter_count; i++) {
+			values[i] += other.values[i];
+			valid[i] = valid[i] || other.valid[i];
+		}
+		return *this;
+	}
+
+	double sample::ratio(counter numerator, counter denominator) const {
+		if (!has(numerator) || !has(denominator) || values[denominator] == 0) {
+			return -1;
+		}
+		return values[numerator] / values[denominator];
+	}
+
+	Counters::Counters() {
+		for (size_t i = 0; i < counter_count; i++) {
+			fds_[i] = open_event(events[i]);
+		}
+	}
+
+	Counters::~Counters() {
+		for (auto fd : fds_) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+	}
+
+	bool Counters::available() const {
+		for (auto fd : fds_) {
+			if (fd >= 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	sample Counters::read() const {
+		sample result;
+		for (size_t i = 0; i < counter_count; i++) {
+			uint64_t data[3];
+			if (fds_[i] < 0 || ::read(fds_[i], data, sizeof(data)) != sizeof(data)) {
+				continue;
+			}
+			// Scale up a multiplexed count to the whole time it was enabled
+			result.values[i] = data[2] == 0 ? 0 : data[0] * (static_cast<double>(data[1]) / data[2]);
+			result.valid[i] = data[2] != 0;
+		}
+		return result;
+	}
+
+	sample difference(const sample& end, const sample& start) {
+		sample result;
+		for (size_t i = 0; i < counter_count; i++) {
+			result.values[i] = end.values[i] - start.values[i];
+			result.valid[i] = end.valid[i] && start.valid[i];
+		}
+		return result;
+	}
+
+	void enable() {
+		if (!shared_counters) {
+			shared_counters = std::make_unique<Counters>();
+		}
+		perf_enabled = shared_counters->available();
+	}
+
+	bool enabled() {
+		return perf_enabled;
+	}
+
+	sample read() {
+		if (!perf_enabled) {
+			return sample{};
+		}
+		auto result = shared_counters->read();
+		std::lock_guard lock{worker_mutex};
+		return result += worker_total;
+	}
+
+	const std::vector<std::pair<std::string, sample>>& totals() {
+		return named_totals;
+	}
+
+	void clear_totals() {
+		named_totals.clear();
+	}
+
+	Scope::Scope(std::string_view name) : active_{perf_enabled}, name_{name} {
+		if (active_) {
+			start_ = read();
+		}
+	}
+
+	Scope::~Scope() {
+		if (!active_) {
+			return;
+		}
+		auto taken = difference(read(), start_);
+		for (auto& total : named_totals) {
+			if (total.first == name_) {
+				total.second += taken;
+				return;
+			}
+		}
+		named_totals.emplace_back(name_, taken);
+	}
+
+	WorkerScope::WorkerScope() {
+		if (perf_enabled) {
+			counters_ = std::make_unique<Counters>();
+			start_ = counters_->read();
+		}
+	}
+
+	WorkerScope::~WorkerScope() {
+		if (!counters_) {
+			return;
+		}
+		auto taken = difference(counters_->read(), start_);
+		std::lock_guard lock{worker_mutex};
+		worker_total += taken;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Hardware counters through Linux perf_event_open, counting user space
+// only so no privileges are needed beyond perf_event_paranoid <= 2.
+// Counters the kernel or cpu can't provide are reported as missing
+namespace crafter::perf {
+	enum counter {cycles, instructions, branches, branch_misses, l1d_loads, l1d_misses, llc_loads, llc_misses, counter_count};
+
+	struct sample {
+		std::array<double, counter_count> values{};
+		std::array<bool, counter_count> valid{};
+
+		sample& operator+=(const sample& other);
+		bool has(counter c) const { return valid[c]; }
+		// Ratio of two counters, negative when either is missing
+		double ratio(counter numerator, counter denominator) const;
+		double ipc() const { return ratio(instructions, cycles); }
+	};
+
+	// One perf event per counter, left running from construction. Readings
+	// are scaled by time enabled over time running in case the kernel had
+	// to multiplex them
+	class Counters {
+	public:
+		Counters();
+		Counters(const Counters&) = delete;
+		Counters& operator=(const Counters&) = delete;
+		~Counters();
+
+		bool available() const;
+		sample read() const;
+	private:
+		std::array<int, counter_count> fds_;
+	};
+
+	sample difference(const sample& end, const sample& start);
+
+	// Named totals for code like the importer which can't own its own
+	// Counters. Scopes are free unless perf::enable() has been called
+	void enable();
+	bool enabled();
+	// Reading of the counters the scopes use, empty unless enabled. The
+	// counters only see the thread that enabled them, so this adds in
+	// whatever WorkerScopes have counted on other threads
+	sample read();
+	const std::vector<std::pair<std::string, sample>>& totals();
+	void clear_totals();
+
+	class Scope {
+	public:
+		explicit Scope(std::string_view name);
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		~Scope();
+	private:
+		bool active_;
+		std::string_view name_;
+		sample start_;
+	};
+
+	// Counts a worker thread's share of the work while it's alive, on
+	// counters of the worker's own, and adds it to read() when it ends.
+	// Safe to use from any thread, and free unless perf::enable() has
+	// been called
+	class WorkerScope {
+	public:
+		WorkerScope();
+		WorkerScope(const WorkerScope&) = delete;
+		WorkerScope& operator=(const WorkerScope&) = delete;
+		~WorkerScope();
+	private:
+		std::unique_ptr<Counters> counters_;
+		sample start_;
+	};
+}
@@ -0,0 +1,80 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace crafter {
+	namespace {
+		constexpr size_t bucket_size = 3;
+		constexpr uint32_t max_displacement = 1 << 24;
+		constexpr int max_seeds = 16;
+
+		// Places every bucket with one seed, false if some bucket can't be placed
+		bool place(const std::vector<uint64_t>& hashes, perfect_hash& result) {
+			auto bucket_count = result.displacements.size();
+			std::vector<std::vector<uint64_t>> buckets(bucket_count);
+			for (auto hash : hashes) {
+				buckets[(hash >> 32) % bucket_count].push_back(hash);
+			}
+			// Largest buckets first, while most slots are still free
+			std::vector<size_t> order(bucket_count);
+			std::iota(order.begin(), order.end(), 0);
+			std::stable_sort(order.begin(), order.end(),
+			                 [&](size_t lhs, size_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+			std::vector<bool> taken(result.slots, false);
+			std::vector<size_t> slots;
+			for (auto bucket : order) {
+				const auto& members = buckets[bucket];
+				if (members.empty()) {
+					break;
+				}
+				bool placed = false;
+				for (uint32_t displacement = 0; displacement < max_displacement && !placed; displacement++) {
+					result.displacements[bucket] = displacement;
+					slots.clear();
+					placed = true;
+					for (auto hash : members) {
+						auto slot = perfect_slot(hash, result.displacements, result.slots);
+						if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+							placed = false;
+							break;
+						}
+						slots.push_back(slot);
+					}
+				}
+				if (!placed) {
+					return false;
+				}
+				for (auto slot : slots) {
+					taken[slot] = true;
+				}
+			}
+			return true;
+		}
+	}
+
+	perfect_hash build_perfect_hash(std::span<const std::string_view> names) {
+		perfect_hash result;
+		result.slots = names.size();
+		std::vector<uint64_t> hashes(names.size());
+		for (int attempt = 0; attempt < max_seeds; attempt++) {
+			result.seed = mix_hash(attempt + 1);
+			result.displacements.assign(std::max<size_t>(1, names.size() / bucket_size), 0);
+			for (size_t i = 0; i < names.size(); i++) {
+				hashes[i] = name_hash(names[i], result.seed);
+			}
+			// Equal hashes can never be split by a displacement
+			auto sorted = hashes;
+			std::sort(sorted.begin(), sorted.end());
+			if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+				continue;
+			}
+			if (place(hashes, result)) {
+				return result;
+			}
+		}
+		throw std::runtime_error("Failed to build the name index\nNames are duplicated or collide on every seed");
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "hash.h"
+
+// CHD style minimal perfect hash over a fixed set of names. Names are
+// split into buckets by one hash, and each bucket gets a displacement that
+// moves all of its names into free slots, so a lookup is one hash, one
+// table read and a compare against the name stored in the slot
+namespace crafter {
+	// FNV-1a, usable at compile time
+	constexpr uint64_t name_hash(std::string_view name, uint64_t seed) {
+		uint64_t hash = 0xcbf29ce484222325 ^ seed;
+		for (char c : name) {
+			hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+		}
+		return mix_hash(hash);
+	}
+
+	// Slot for a name hash, always in range even for names outside the set
+	constexpr size_t perfect_slot(uint64_t hash, std::span<const uint32_t> displacements, size_t slots) {
+		if (slots == 0) {
+			return 0;
+		}
+		uint64_t displacement = displacements[(hash >> 32) % displacements.size()];
+		return mix_hash(hash + displacement * 0x9e3779b97f4a7c15) % slots;
+	}
+
+	struct perfect_hash {
+		uint64_t seed = 0;
+		std::vector<uint32_t> displacements;
+		size_t slots = 0;
+
+		size_t slot(std::string_view name) const {
+			return perfect_slot(name_hash(name, seed), displacements, slots);
+		}
+	};
+
+	// Names must be unique, every name gets a different slot below names.size()
+	perfect_hash build_perfect_hash(std::span<const std::string_view> names);
+}
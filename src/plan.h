@@ -0,0 +1,20 @@
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.h"
+#include "hash.h"
+
+struct craft_count {
+	size_t count = 0;
+	size_t needed = 0;
+	bool ready = false;
+	size_t distance = 0;
+};
+
+using recipe_graph_t = graph::Graph<std::string, int>;
+using craft_store = std::pmr::unordered_map<std::string, craft_count, crafter::string_hash, crafter::string_equal>;
+using craft_order = std::vector<std::vector<std::string>>;
@@ -0,0 +1,279 @@
+#include "planner.h"
+
+#include <string>
+#include <unordered_set>
+#include <deque>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "dense_graph.h"
+#include "graph.h"
+#include "hash.h"
+
+// Walks the index by ID, so only the request names are hashed to find
+// the recipes. Names the index doesn't know are left as lone nodes
+recipe_graph_t build_graph(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_index& recipes,
+                           std::pmr::memory_resource* resource) {
+	using id_t = crafter::recipe_index::id_t;
+	std::pmr::deque<id_t> queue{resource};
+	std::pmr::unordered_set<id_t> seen{resource};
+	recipe_graph_t graph_{graph::allocator_type{resource}};
+	for (const auto& request : requests) {
+		auto id = recipes.id(request.name);
+		if (id == crafter::recipe_index::npos) {
+			graph_.InsertNode(request.name);
+		} else if (seen.insert(id).second) {
+			queue.push_back(id);
+		}
+	}
+	while (!queue.empty()) {
+		auto request = queue[0];
+		queue.pop_front();
+		auto name = recipes.name(request);
+		graph_.InsertNode(name);
+		for (const auto& ingredient : recipes.ingredients(request)) {
+			auto ingredient_name = recipes.name(ingredient.id);
+			graph_.InsertNode(ingredient_name);
+			graph_.InsertEdge(name, ingredient_name, ingredient.count);
+			if (seen.insert(ingredient.id).second) {
+				queue.push_back(ingredient.id);
+			}
+		}
+	}
+	return graph_;
+}
+
+// Goes by name, since the lazy recipes only know the names they've indexed
+// and parse each recipe as it's found
+recipe_graph_t build_graph(const std::vector<crafter::Ingredients>& requests, crafter::lazy_recipes& recipes,
+                           std::pmr::memory_resource* resource) {
+	// Names point into requests and recipes, which outlive the traversal
+	std::pmr::deque<std::string_view> queue{resource};
+	std::pmr::unordered_set<std::string_view> seen{resource};
+	for (const auto& request : requests) {
+		queue.push_back(request.name);
+		seen.insert(request.name);
+	}
+	recipe_graph_t graph_{graph::allocator_type{resource}};
+	while (!queue.empty()) {
+		auto request = queue[0];
+		queue.pop_front();
+		graph_.InsertNode(request);
+		auto alternatives = recipes.find(request);
+		if (alternatives != nullptr) {
+			auto& recipe = (*alternatives)[0];
+			for (const auto& ingredient : recipe.ingredients) {
+				graph_.InsertNode(ingredient.name);
+				graph_.InsertEdge(request, ingredient.name, ingredient.count);
+				if (!seen.count(ingredient.name)) {
+					seen.insert(ingredient.name);
+					queue.push_back(ingredient.name);
+				}
+			}
+		}
+	}
+	return graph_;
+}
+
+namespace {
+	using node_id = uint32_t;
+	// Ids are integral, so this picks DenseGraph
+	using id_graph_t = graph::select_graph_t<node_id, int>;
+
+	// The requests' part of the recipe graph numbered 0 to size() - 1 in
+	// the order it's reached, so counting can index flat arrays. Built
+	// straight from the index's IDs, through a map sized by the plan rather
+	// than the whole index
+	struct interned_graph {
+		using global_id = crafter::recipe_index::id_t;
+
+		id_graph_t graph;
+		// Index ID of each node, and its first recipe, nullptr for raw materials
+		std::pmr::vector<global_id> global;
+		std::pmr::vector<const crafter::Recipe*> recipes;
+		// Node of each request, in request order
+		std::pmr::vector<node_id> requested;
+
+		interned_graph(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_index& index, std::pmr::memory_resource* resource)
+			: global{resource}, recipes{resource}, requested{resource} {
+			std::pmr::unordered_map<global_id, node_id> local{resource};
+			auto intern = [&](global_id id) {
+				auto [it, added] = local.try_emplace(id, static_cast<node_id>(global.size()));
+				if (added) {
+					if (global.size() >= std::numeric_limits<node_id>::max()) {
+						throw std::length_error("Recipe graph has too many nodes to number");
+					}
+					global.push_back(id);
+					auto alternatives = index.recipes(id);
+					recipes.push_back(alternatives != nullptr ? &(*alternatives)[0] : nullptr);
+					graph.InsertNode(it->second);
+				}
+				return it->second;
+			};
+			requested.reserve(requests.size());
+			for (const auto& request : requests) {
+				auto id = index.id(request.name);
+				if (id == crafter::recipe_index::npos || index.recipes(id) == nullptr) {
+					throw std::invalid_argument("No recipe for " + request.name);
+				}
+				requested.push_back(intern(id));
+			}
+			// Nodes are appended as they're reached, so this is a breadth first walk
+			for (node_id src = 0; src < global.size(); src++) {
+				for (const auto& ingredient : index.ingredients(global[src])) {
+					graph.InsertEdge(src, intern(ingredient.id), ingredient.count);
+				}
+			}
+		}
+
+		size_t size() const { return global.size(); }
+	};
+
+	// Counts by node id. A node only shows up in the final plan once it's
+	// been given a count, as a craft_store entry would be created
+	struct tally_state {
+		std::pmr::vector<craft_count> counts;
+		std::pmr::vector<bool> present;
+
+		tally_state(size_t size, std::pmr::memory_resource* resource)
+			: counts(size, resource), present(size, false, resource) {}
+
+		craft_count& count_of(node_id id) {
+			present[id] = true;
+			return counts[id];
+		}
+	};
+
+	bool check_ingredient(node_id ingredient, tally_state& state, const interned_graph& plan) {
+		craft_count count;
+		if (state.present[ingredient]) {
+			count = state.counts[ingredient];
+			if (count.ready) {
+				return true;
+			}
+		}
+		decltype(count.distance) parent_distance = 0;
+		for (auto parent : plan.graph.Incoming(ingredient)) {
+			const auto& parent_count = state.count_of(parent);
+			if (!parent_count.ready) {
+				return false;
+			}
+			count.needed += parent_count.count * plan.graph.GetWeight(parent, ingredient);
+			parent_distance = std::max(parent_distance, parent_count.distance);
+		}
+		count.distance = parent_distance + 1;
+		auto recipe = plan.recipes[ingredient];
+		if (recipe == nullptr) {
+			count.ready = true;
+			count.count = count.needed;
+		} else {
+			count.count = ceil(count.needed / (double) recipe->makes);
+			count.ready = true;
+		}
+		state.count_of(ingredient) = count;
+		return recipe != nullptr;
+	}
+
+	bool check_parent(node_id parent, tally_state& state, const interned_graph& plan) {
+		size_t child_distance = -1;
+		for (auto child : plan.graph.Connected(parent)) {
+			const auto& child_count = state.count_of(child);
+			if (!child_count.ready) {
+				return false;
+			}
+			child_distance = std::min(child_distance, child_count.distance);
+		}
+		auto& parent_count = state.count_of(parent);
+		parent_count.distance = child_distance - 1;
+		parent_count.ready = true;
+		return true;
+	}
+}
+
+craft_store tally_count(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_index& recipes,
+                        std::pmr::memory_resource* resource) {
+	interned_graph plan{requests, recipes, resource};
+	tally_state state{plan.size(), resource};
+	std::pmr::deque<node_id> queue{resource};
+	for (size_t i = 0; i < requests.size(); i++) {
+		const auto& node = requests[i];
+		auto id = plan.requested[i];
+		auto needed = static_cast<size_t>(node.count);
+		auto count = (size_t) ceil(needed / (double) plan.recipes[id]->makes);
+		bool head = plan.graph.Incoming(id).empty();
+		state.count_of(id) = craft_count{count, needed, head, 0};
+		queue.push_back(id);
+	}
+	while (!queue.empty()) {
+		auto request = queue[0];
+		queue.pop_front();
+		for (auto ingredient : plan.graph.Connected(request)) {
+			auto ready = check_ingredient(ingredient, state, plan);
+			if (ready) {
+				queue.push_back(ingredient);
+			}
+		}
+	}
+
+	std::pmr::vector<node_id> tails{resource};
+	for (auto node : plan.graph) {
+		if (plan.graph.Connected(node).empty()) {
+			tails.push_back(node);
+		}
+	}
+
+	size_t max_distance = 0;
+	for (auto tail : tails) {
+		max_distance = std::max(max_distance, state.count_of(tail).distance);
+	}
+
+	for (auto& count : state.counts) {
+		count.ready = false;
+	}
+
+	for (auto tail : tails) {
+		queue.push_back(tail);
+		auto& tail_count = state.count_of(tail);
+		tail_count.distance = max_distance;
+		tail_count.ready = true;
+	}
+
+	while (!queue.empty()) {
+		auto request = queue[0];
+		queue.pop_front();
+		for (auto parent : plan.graph.Incoming(request)) {
+			auto ready = check_parent(parent, state, plan);
+			if (ready) {
+				queue.push_back(parent);
+			}
+		}
+	}
+
+	craft_store recipe_count{resource};
+	recipe_count.reserve(plan.size());
+	for (node_id id = 0; id < plan.size(); id++) {
+		if (state.present[id]) {
+			recipe_count.emplace(recipes.name(plan.global[id]), state.counts[id]);
+		}
+	}
+	return recipe_count;
+}
+
+craft_order get_order (const craft_store& recipe_count) {
+	craft_order result;
+	for (const auto& it : recipe_count) {
+		auto& name = it.first;
+		auto& craft = it.second;
+		if (craft.distance >= result.size()) {
+			result.resize(craft.distance + 1);
+		}
+		result[craft.distance].push_back(name);
+	}
+	for (auto& level : result) {
+		std::sort(level.begin(), level.end());
+	}
+	return result;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "import.h"
+#include "lazy_recipes.h"
+#include "plan.h"
+#include "recipe_index.h"
+
+// The graph and plan, and the scratch space used to build them, come from
+// resource. Passing a monotonic arena frees a whole request at once
+recipe_graph_t build_graph(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_index& recipes,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+// Parses only the recipes the requests reach, recipes.loaded() holds them after
+recipe_graph_t build_graph(const std::vector<crafter::Ingredients>& requests, crafter::lazy_recipes& recipes,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+// Counts over the recipes the requests reach, walked by index ID. Throws
+// std::invalid_argument for a request with no recipe
+craft_store tally_count(const std::vector<crafter::Ingredients>& requests, const crafter::recipe_index& recipes,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+craft_order get_order (const craft_store& recipe_count);
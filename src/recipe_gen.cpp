@@ -0,0 +1,148 @@
+#include "recipe_gen.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+	// splitmix64, so packs are identical on every platform and standard library
+	class generator {
+	public:
+		explicit generator(uint64_t seed) : state_{seed} {}
+		uint64_t next() {
+			uint64_t z = (state_ += 0x9e3779b97f4a7c15);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+			return z ^ (z >> 31);
+		}
+		size_t below(size_t bound) { return bound == 0 ? 0 : next() % bound; }
+		double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+	private:
+		uint64_t state_;
+	};
+
+	struct layout {
+		size_t layers;
+		size_t items;
+		size_t begin(size_t layer) const { return items * layer / layers; }
+		size_t end(size_t layer) const { return items * (layer + 1) / layers; }
+	};
+
+	std::string anchor_name(size_t item) {
+		return "i" + std::to_string(item);
+	}
+
+	void write_recipe(std::string& out, size_t item, int makes, const std::vector<std::pair<size_t, int>>& ingredients, bool anchored = false) {
+		out += crafter::synthetic_name(item);
+		out += ":\n  ingredients:";
+		if (anchored) {
+			out += " &";
+			out += anchor_name(item);
+		}
+		out += "\n";
+		for (const auto& ingredient : ingredients) {
+			out += "    ";
+			out += crafter::synthetic_name(ingredient.first);
+			out += ": ";
+			out += std::to_string(ingredient.second);
+			out += "\n";
+		}
+		out += "  makes: ";
+		out += std::to_string(makes);
+		out += "\n";
+	}
+
+	void write_shared_recipe(std::string& out, size_t item, int makes, size_t shared) {
+		out += crafter::synthetic_name(item);
+		out += ":\n  ingredients: *";
+		out += anchor_name(shared);
+		out += "\n  makes: ";
+		out += std::to_string(makes);
+		out += "\n";
+	}
+}
+
+namespace crafter {
+	std::string synthetic_name(size_t item) {
+		return "Item " + std::to_string(item);
+	}
+
+	synthetic_pack generate_recipes(const synthetic_options& options) {
+		if (options.depth == 0 || options.fan_in == 0 || options.max_makes < 1) {
+			throw std::invalid_argument("Synthetic recipes need a depth, fan in and max makes of at least 1");
+		}
+		layout layers{options.depth + 1, options.items};
+		if (layers.begin(1) == 0) {
+			throw std::invalid_argument("Synthetic recipes need more items than layers");
+		}
+		generator rng{options.seed};
+		std::vector<size_t> uses(options.items, 0);
+		synthetic_pack pack;
+		pack.files.resize(2);
+		std::vector<std::pair<size_t, int>> ingredients;
+		// Recipes in the current layer with anchored ingredients
+		std::vector<size_t> anchored;
+
+		auto pick = [&](size_t lowest, size_t highest) {
+			// Prefer items under the fan out limit, but give up after a few tries
+			size_t item = lowest + rng.below(highest - lowest);
+			for (int attempt = 0; attempt < 4 && options.fan_out && uses[item] >= options.fan_out; attempt++) {
+				item = lowest + rng.below(highest - lowest);
+			}
+			return item;
+		};
+		auto add = [&](size_t item) {
+			for (const auto& existing : ingredients) {
+				if (existing.first == item) {
+					return;
+				}
+			}
+			uses[item]++;
+			ingredients.emplace_back(item, 1 + static_cast<int>(rng.below(8)));
+		};
+		auto makes = [&]() {
+			if (options.max_makes == 1 || rng.below(2) == 0) {
+				return 1;
+			}
+			return 2 + static_cast<int>(rng.below(options.max_makes - 1));
+		};
+
+		for (size_t layer = 1; layer < layers.layers; layer++) {
+			anchored.clear();
+			for (size_t item = layers.begin(layer); item < layers.end(layer); item++) {
+				// Shared lists only come from the same layer, so the DAG is kept.
+				// They don't count towards the fan out limit
+				if (!anchored.empty() && options.shared > 0 && rng.unit() < options.shared) {
+					write_shared_recipe(pack.files[0], item, makes(), anchored[rng.below(anchored.size())]);
+				} else {
+					ingredients.clear();
+					auto count = 1 + rng.below(options.fan_in);
+					for (size_t i = 0; i < count; i++) {
+						// Mostly the layer directly below, so depth is actually reached
+						if (rng.below(10) < 7) {
+							add(pick(layers.begin(layer - 1), layers.end(layer - 1)));
+						} else {
+							add(pick(0, layers.begin(layer)));
+						}
+					}
+					write_recipe(pack.files[0], item, makes(), ingredients, options.shared > 0);
+					if (options.shared > 0) {
+						anchored.push_back(item);
+					}
+				}
+
+				if (rng.unit() < options.alternatives) {
+					ingredients.clear();
+					add(pick(0, layers.begin(layer)));
+					if (rng.unit() < options.cycles) {
+						add(pick(layers.begin(layer), options.items));
+					}
+					write_recipe(pack.files[1], item, makes(), ingredients);
+				}
+			}
+		}
+		for (size_t item = layers.begin(layers.layers - 1); item < options.items; item++) {
+			pack.top.push_back(synthetic_name(item));
+		}
+		return pack;
+	}
+}
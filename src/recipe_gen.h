@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Deterministic synthetic recipe packs for benchmarking. Items are split
+// into layers, layer 0 being raw materials, and each recipe draws its
+// ingredients from lower layers so the primary recipes always form a DAG
+namespace crafter {
+	struct synthetic_options {
+		size_t items = 1000;
+		// Recipe layers above the raw materials
+		size_t depth = 8;
+		// Most ingredients in one recipe
+		size_t fan_in = 4;
+		// Most recipes an item is used in, 0 for no limit
+		size_t fan_out = 0;
+		// makes is 1 half the time, otherwise uniform in [2, max_makes]
+		int max_makes = 4;
+		// Fraction of crafted items which get an alternative recipe
+		double alternatives = 0.0;
+		// Fraction of alternative recipes which use an item from the same
+		// or a higher layer. The planner only follows an item's first
+		// recipe, so these cycles are visible to the importer only
+		double cycles = 0.0;
+		// Fraction of recipes which reuse the ingredients of an earlier
+		// recipe in their layer through a YAML alias. When set, every other
+		// ingredient list in the first file gets an anchor
+		double shared = 0.0;
+		uint64_t seed = 1;
+	};
+
+	struct synthetic_pack {
+		// Recipe files in load order, alternatives come in the second file
+		std::vector<std::string> files;
+		// Items in the top layer, in generation order
+		std::vector<std::string> top;
+	};
+
+	synthetic_pack generate_recipes(const synthetic_options& options);
+	std::string synthetic_name(size_t item);
+}
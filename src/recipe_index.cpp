@@ -0,0 +1,78 @@
+#include "recipe_index.h"
+
+#include <stdexcept>
+#include <unordered_set>
+
+namespace crafter {
+	recipe_index::recipe_index(const recipe_store& recipes) {
+		std::vector<std::string_view> names;
+		std::unordered_set<std::string_view> seen;
+		names.reserve(recipes.size());
+		seen.reserve(recipes.size());
+		for (const auto& recipe : recipes) {
+			names.push_back(recipe.first);
+			seen.insert(recipe.first);
+		}
+		// Raw materials only ever show up as ingredients
+		for (const auto& recipe : recipes) {
+			for (const auto& alternative : recipe.second) {
+				for (const auto& ingredient : alternative.ingredients) {
+					if (seen.insert(ingredient.name).second) {
+						names.push_back(ingredient.name);
+					}
+				}
+			}
+		}
+		hash_ = build_perfect_hash(names);
+		slots_.resize(names.size());
+		for (const auto& name : names) {
+			slots_[hash_.slot(name)].name = name;
+		}
+		for (const auto& recipe : recipes) {
+			slots_[hash_.slot(recipe.first)].recipes = &recipe.second;
+		}
+		link_ingredients();
+	}
+
+	recipe_index::recipe_index(perfect_hash hash, std::span<const std::string_view> names, std::span<const std::vector<Recipe>> recipes)
+		: hash_{std::move(hash)}, slots_(names.size()) {
+		for (size_t i = 0; i < names.size(); i++) {
+			slots_[i].name = names[i];
+			slots_[i].recipes = recipes[i].empty() ? nullptr : &recipes[i];
+		}
+		link_ingredients();
+	}
+
+	// Resolves each first recipe's ingredients to IDs once, so walking the
+	// recipes by ID never hashes a name
+	void recipe_index::link_ingredients() {
+		for (auto& slot : slots_) {
+			if (slot.recipes == nullptr) {
+				continue;
+			}
+			const auto& recipe = (*slot.recipes)[0];
+			slot.first_ingredient = static_cast<uint32_t>(ingredients_.size());
+			slot.ingredient_count = static_cast<uint32_t>(recipe.ingredients.size());
+			for (const auto& ingredient : recipe.ingredients) {
+				auto ingredient_id = id(ingredient.name);
+				if (ingredient_id == npos) {
+					throw std::invalid_argument("Ingredient " + ingredient.name + " of " + std::string(slot.name) + " isn't indexed");
+				}
+				ingredients_.push_back({ingredient_id, ingredient.count});
+			}
+		}
+	}
+
+	recipe_index::id_t recipe_index::id(std::string_view name) const {
+		if (slots_.empty()) {
+			return npos;
+		}
+		auto slot = hash_.slot(name);
+		return slots_[slot].name == name ? static_cast<id_t>(slot) : npos;
+	}
+
+	const std::vector<Recipe>* recipe_index::find(std::string_view name) const {
+		auto i = id(name);
+		return i == npos ? nullptr : slots_[i].recipes;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "import.h"
+#include "perfect_hash.h"
+
+namespace crafter {
+	// Flat name to ID table over every recipe and ingredient name in a
+	// recipe_store, addressed by a minimal perfect hash. An ID is the name's
+	// slot, so raw materials have IDs too. Slots point back into the store,
+	// which has to outlive the index and stay unchanged
+	class recipe_index {
+	public:
+		using id_t = uint32_t;
+		static constexpr id_t npos = static_cast<id_t>(-1);
+
+		// An ingredient of a name's first recipe
+		struct ingredient {
+			id_t id;
+			int count;
+		};
+
+		recipe_index() = default;
+		explicit recipe_index(const recipe_store& recipes);
+		// Reuses a hash which already puts names[i] in slot i, as the embedded
+		// database's does. recipes[i] are the recipes for names[i], empty for
+		// raw materials, and both have to outlive the index
+		recipe_index(perfect_hash hash, std::span<const std::string_view> names, std::span<const std::vector<Recipe>> recipes);
+
+		size_t size() const { return slots_.size(); }
+		// ID of a name, npos if it isn't in the store
+		id_t id(std::string_view name) const;
+		std::string_view name(id_t id) const { return slots_[id].name; }
+		// Recipes for an ID, nullptr for raw materials
+		const std::vector<Recipe>* recipes(id_t id) const { return slots_[id].recipes; }
+		// Ingredients of the first recipe, what the planner follows
+		std::span<const ingredient> ingredients(id_t id) const {
+			return std::span(ingredients_).subspan(slots_[id].first_ingredient, slots_[id].ingredient_count);
+		}
+		// Recipes for a name, nullptr for raw materials and unknown names
+		const std::vector<Recipe>* find(std::string_view name) const;
+
+	private:
+		struct slot {
+			std::string_view name;
+			const std::vector<Recipe>* recipes = nullptr;
+			uint32_t first_ingredient = 0;
+			uint32_t ingredient_count = 0;
+		};
+		perfect_hash hash_;
+		std::vector<slot> slots_;
+		std::vector<ingredient> ingredients_;
+
+		void link_ingredients();
+	};
+}
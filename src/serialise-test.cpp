@@ -0,0 +1,116 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "graph.h"
+#include "plan.h"
+#include "serialise.h"
+#include "testing.h"
+
+namespace {
+	using crafter::testing::check;
+
+	std::span<const char> span_of(const std::string& data) {
+		return std::span<const char>(data.data(), data.size());
+	}
+
+	// Whether loading throws the usual runtime_error, anything else fails
+	template <typename Load>
+	bool rejects(Load load) {
+		try {
+			load();
+		} catch (const std::runtime_error& e) {
+			return std::string(e.what()).substr(0, 14) == "Failed to load";
+		}
+		return false;
+	}
+
+	graph::Graph<std::string, int> sample_graph() {
+		graph::Graph<std::string, int> g;
+		for (auto name : {"Iron Ingot", "Iron Plate", "Gear", "Machine", "Stick"}) {
+			g.InsertNode(name);
+		}
+		g.InsertEdge("Machine", "Gear", 4);
+		g.InsertEdge("Machine", "Iron Plate", 8);
+		g.InsertEdge("Gear", "Iron Ingot", 4);
+		g.InsertEdge("Iron Plate", "Iron Ingot", 1);
+		g.InsertEdge("Gear", "Gear", -2);
+		return g;
+	}
+
+	craft_store sample_plan() {
+		craft_store plan;
+		plan["Machine"] = craft_count{1, 1, true, 0};
+		plan["Gear"] = craft_count{4, 4, false, 1};
+		plan["Iron Ingot"] = craft_count{24, 24, true, 300};
+		return plan;
+	}
+
+	void graph_round_trip() {
+		auto g = sample_graph();
+		std::ostringstream out;
+		serialise::save_graph(out, g);
+		auto loaded = serialise::load_graph<std::string, int>(span_of(out.str()));
+		check(loaded == g, "graph round trip");
+		check(loaded.GetWeight("Gear", "Gear") == -2, "graph round trip keeps negative weights");
+
+		graph::Graph<std::string, int> empty;
+		std::ostringstream empty_out;
+		serialise::save_graph(empty_out, empty);
+		check(serialise::load_graph<std::string, int>(span_of(empty_out.str())).size() == 0, "empty graph round trip");
+	}
+
+	void plan_round_trip() {
+		auto plan = sample_plan();
+		std::ostringstream out;
+		serialise::save_plan(out, plan);
+		auto loaded = serialise::load_plan(span_of(out.str()));
+		bool same = loaded.size() == plan.size();
+		for (const auto& it : plan) {
+			auto found = loaded.find(it.first);
+			same = same && found != loaded.end() && found->second.count == it.second.count && found->second.needed == it.second.needed &&
+			       found->second.distance == it.second.distance && found->second.ready == it.second.ready;
+		}
+		check(same, "plan round trip");
+	}
+
+	// Every prefix of a valid file is rejected with the load error
+	void truncated() {
+		std::ostringstream graph_out, plan_out;
+		serialise::save_graph(graph_out, sample_graph());
+		serialise::save_plan(plan_out, sample_plan());
+		auto graph_data = graph_out.str();
+		auto plan_data = plan_out.str();
+		for (size_t size = 0; size < graph_data.size(); size++) {
+			auto prefix = graph_data.substr(0, size);
+			check(rejects([&]() { serialise::load_graph<std::string, int>(span_of(prefix)); }), "truncated graph " + std::to_string(size));
+		}
+		for (size_t size = 0; size < plan_data.size(); size++) {
+			auto prefix = plan_data.substr(0, size);
+			check(rejects([&]() { serialise::load_plan(span_of(prefix)); }), "truncated plan " + std::to_string(size));
+		}
+	}
+
+	// Counts far larger than the input must not be trusted for a reserve
+	void huge_counts() {
+		std::string huge = "\xff\xff\xff\xff\xff\xff\xff\x7f";
+		auto plan = std::string("CPLN\x01") + huge;
+		check(plan.size() == 13, "corrupt plan is 13 bytes");
+		check(rejects([&]() { serialise::load_plan(span_of(plan)); }), "huge plan entry count");
+		auto nodes = std::string("CGRF\x01") + huge;
+		check(rejects([&]() { serialise::load_graph<std::string, int>(span_of(nodes)); }), "huge graph node count");
+		// One empty named node with a huge degree
+		auto degree = std::string("CGRF\x01\x01\x00", 7) + huge;
+		check(rejects([&]() { serialise::load_graph<std::string, int>(span_of(degree)); }), "huge graph degree");
+		auto name = std::string("CGRF\x01\x01") + huge;
+		check(rejects([&]() { serialise::load_graph<std::string, int>(span_of(name)); }), "huge node name");
+	}
+}
+
+int main() {
+	graph_round_trip();
+	plan_round_trip();
+	truncated();
+	huge_counts();
+	return crafter::testing::result();
+}
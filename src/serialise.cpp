@@ -0,0 +1,114 @@
+#include "serialise.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace serialise {
+	constexpr std::string_view plan_magic = "CPLN";
+	constexpr uint64_t plan_version = 1;
+	// Name length, count, needed, distance and ready
+	constexpr size_t min_plan_entry = 5;
+
+	void Writer::varint(uint64_t value) {
+		while (value >= 0x80) {
+			byte(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		byte(static_cast<uint8_t>(value));
+	}
+
+	uint8_t Reader::byte() {
+		if (pos_ == end_) {
+			throw std::runtime_error("Failed to load data\nUnexpected end of input");
+		}
+		return static_cast<uint8_t>(*pos_++);
+	}
+
+	std::string_view Reader::bytes(size_t count) {
+		if (static_cast<size_t>(end_ - pos_) < count) {
+			throw std::runtime_error("Failed to load data\nUnexpected end of input");
+		}
+		std::string_view result{pos_, count};
+		pos_ += count;
+		return result;
+	}
+
+	uint64_t Reader::varint() {
+		uint64_t result = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7) {
+			auto next = byte();
+			result |= static_cast<uint64_t>(next & 0x7f) << shift;
+			if (!(next & 0x80)) {
+				return result;
+			}
+		}
+		throw std::runtime_error("Failed to load data\nVarint is too long");
+	}
+
+	uint64_t Reader::count(size_t min_size) {
+		auto result = varint();
+		if (result > remaining() / min_size) {
+			throw std::runtime_error("Failed to load data\nCount is larger than the input");
+		}
+		return result;
+	}
+
+	void save_plan(std::ostream& os, const craft_store& plan) {
+		// Sorted so the same plan always saves to the same bytes
+		std::vector<const craft_store::value_type*> entries;
+		entries.reserve(plan.size());
+		for (const auto& entry : plan) {
+			entries.push_back(&entry);
+		}
+		std::sort(entries.begin(), entries.end(),
+		          [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+
+		std::string buffer;
+		Writer out{buffer};
+		out.bytes(plan_magic);
+		out.varint(plan_version);
+		out.varint(entries.size());
+		for (const auto* entry : entries) {
+			const auto& craft = entry->second;
+			codec<std::string>::write(out, entry->first);
+			out.varint(craft.count);
+			out.varint(craft.needed);
+			out.varint(craft.distance);
+			out.byte(craft.ready);
+		}
+		os.write(buffer.data(), buffer.size());
+	}
+
+	craft_store load_plan(std::span<const char> data) {
+		Reader in{data};
+		if (in.bytes(plan_magic.size()) != plan_magic) {
+			throw std::runtime_error("Failed to load plan\nThe file is not a saved plan");
+		}
+		if (in.varint() != plan_version) {
+			throw std::runtime_error("Failed to load plan\nUnsupported plan version");
+		}
+		auto entries = in.count(min_plan_entry);
+		craft_store plan;
+		plan.reserve(entries);
+		for (uint64_t i = 0; i < entries; i++) {
+			auto name = codec<std::string>::read(in);
+			craft_count craft;
+			craft.count = in.varint();
+			craft.needed = in.varint();
+			craft.distance = in.varint();
+			craft.ready = in.byte() != 0;
+			plan.emplace(std::move(name), craft);
+		}
+		return plan;
+	}
+
+	craft_store load_plan(std::istream& is) {
+		auto data = read_all(is);
+		return load_plan(std::span<const char>(data.data(), data.size()));
+	}
+
+	std::string read_all(std::istream& is) {
+		return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+	}
+}
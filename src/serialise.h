@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef CRAFTER_SERIALISE
+#define CRAFTER_SERIALISE
+
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "graph.h"
+#include "plan.h"
+
+// Compact binary format for graphs and craft plans. All integers are
+// LEB128 varints (zigzag for signed types) and edges are stored per node
+// as delta encoded destination indices, so a file can be read straight
+// out of a memory mapping with the span overloads
+namespace serialise {
+	// Appends encoded data to a byte string
+	class Writer {
+	public:
+		explicit Writer(std::string& out) : out_{out} {}
+		void byte(uint8_t value) { out_.push_back(static_cast<char>(value)); }
+		void bytes(std::string_view value) { out_.append(value); }
+		void varint(uint64_t value);
+	private:
+		std::string& out_;
+	};
+
+	// Reads encoded data from a borrowed byte buffer
+	class Reader {
+	public:
+		explicit Reader(std::span<const char> in) : pos_{in.data()}, end_{in.data() + in.size()} {}
+		uint8_t byte();
+		std::string_view bytes(size_t count);
+		uint64_t varint();
+		// A varint count of records which each take at least min_size
+		// bytes, checked against the input left so a corrupt count can't
+		// ask for a huge allocation
+		uint64_t count(size_t min_size);
+		size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
+		bool done() const { return pos_ == end_; }
+	private:
+		const char* pos_;
+		const char* end_;
+	};
+
+	inline uint64_t zigzag(int64_t value) {
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	inline int64_t unzigzag(uint64_t value) {
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	// Node and edge codecs, specialise to store other types. Every value
+	// has to encode to at least one byte
+	template <typename T, typename = void>
+	struct codec;
+
+	template <typename T>
+	struct codec<T, std::enable_if_t<std::is_integral_v<T>>> {
+		static void write(Writer& out, T value) {
+			if constexpr (std::is_signed_v<T>) {
+				out.varint(zigzag(value));
+			} else {
+				out.varint(value);
+			}
+		}
+		static T read(Reader& in) {
+			if constexpr (std::is_signed_v<T>) {
+				return static_cast<T>(unzigzag(in.varint()));
+			} else {
+				return static_cast<T>(in.varint());
+			}
+		}
+	};
+
+	template <>
+	struct codec<std::string> {
+		static void write(Writer& out, std::string_view value) {
+			out.varint(value.size());
+			out.bytes(value);
+		}
+		static std::string read(Reader& in) {
+			auto size = in.varint();
+			return std::string(in.bytes(size));
+		}
+	};
+
+	template <typename N, typename E, typename NodeCodec = codec<N>, typename EdgeCodec = codec<E>>
+	void save_graph(std::ostream& os, const graph::Graph<N, E>& graph);
+
+	template <typename N, typename E, typename NodeCodec = codec<N>, typename EdgeCodec = codec<E>>
+	void save_graph(std::ostream& os, const graph::FrozenGraph<N, E>& graph);
+
+	template <typename N, typename E, typename NodeCodec = codec<N>, typename EdgeCodec = codec<E>>
+	graph::Graph<N, E> load_graph(std::span<const char> data);
+
+	template <typename N, typename E, typename NodeCodec = codec<N>, typename EdgeCodec = codec<E>>
+	graph::Graph<N, E> load_graph(std::istream& is);
+
+	void save_plan(std::ostream& os, const craft_store& plan);
+	craft_store load_plan(std::span<const char> data);
+	craft_store load_plan(std::istream& is);
+
+	std::string read_all(std::istream& is);
+}
+
+#include "serialise.tpp"
+
+#endif /* end of include guard: CRAFTER_SERIALISE */
@@ -0,0 +1,76 @@
+#include "serialise.h"
+
+#include <stdexcept>
+
+namespace serialise {
+	constexpr std::string_view graph_magic = "CGRF";
+	constexpr uint64_t graph_version = 1;
+
+	template <typename N, typename E, typename NodeCodec, typename EdgeCodec>
+	void save_graph(std::ostream& os, const graph::Graph<N, E>& graph) {
+		save_graph<N, E, NodeCodec, EdgeCodec>(os, graph.Freeze());
+	}
+
+	template <typename N, typename E, typename NodeCodec, typename EdgeCodec>
+	void save_graph(std::ostream& os, const graph::FrozenGraph<N, E>& graph) {
+		std::string buffer;
+		Writer out{buffer};
+		out.bytes(graph_magic);
+		out.varint(graph_version);
+		out.varint(graph.size());
+		for (const auto& node : graph) {
+			NodeCodec::write(out, node);
+		}
+		for (size_t i = 0; i < graph.size(); i++) {
+			auto edges = graph.Connected(i);
+			auto weights = graph.Weights(i);
+			out.varint(edges.size());
+			// Destinations are sorted, so only the gap to the previous one is stored
+			uint64_t previous = 0;
+			for (size_t j = 0; j < edges.size(); j++) {
+				out.varint(edges[j] - previous);
+				previous = edges[j];
+				EdgeCodec::write(out, weights[j]);
+			}
+		}
+		os.write(buffer.data(), buffer.size());
+	}
+
+	template <typename N, typename E, typename NodeCodec, typename EdgeCodec>
+	graph::Graph<N, E> load_graph(std::span<const char> data) {
+		Reader in{data};
+		if (in.bytes(graph_magic.size()) != graph_magic) {
+			throw std::runtime_error("Failed to load graph\nThe file is not a saved graph");
+		}
+		if (in.varint() != graph_version) {
+			throw std::runtime_error("Failed to load graph\nUnsupported graph version");
+		}
+		// Each node takes its value and its degree, each edge a gap and a weight
+		auto node_count = in.count(2);
+		std::vector<N> values;
+		values.reserve(node_count);
+		graph::Graph<N, E> result;
+		for (uint64_t i = 0; i < node_count; i++) {
+			values.push_back(NodeCodec::read(in));
+			result.InsertNode(values.back());
+		}
+		for (const auto& src : values) {
+			auto degree = in.count(2);
+			uint64_t dst = 0;
+			for (uint64_t j = 0; j < degree; j++) {
+				dst += in.varint();
+				if (dst >= values.size()) {
+					throw std::runtime_error("Failed to load graph\nEdge points outside the graph");
+				}
+				result.InsertEdge(src, values[dst], EdgeCodec::read(in));
+			}
+		}
+		return result;
+	}
+
+	template <typename N, typename E, typename NodeCodec, typename EdgeCodec>
+	graph::Graph<N, E> load_graph(std::istream& is) {
+		auto data = read_all(is);
+		return load_graph<N, E, NodeCodec, EdgeCodec>(std::span<const char>(data.data(), data.size()));
+	}
+}
@@ -0,0 +1,130 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "import.h"
+#include "lazy_recipes.h"
+#include "testing.h"
+#include "yaml_split.h"
+
+namespace {
+	using crafter::testing::check;
+
+	// Recipe names and makes in store order, so two stores can be compared
+	std::string describe(const crafter::recipe_store& recipes) {
+		std::ostringstream os;
+		for (const auto& it : recipes) {
+			for (const auto& recipe : it.second) {
+				os << recipe.name << "=" << recipe.makes << "/" << recipe.ingredients.size() << ";";
+			}
+		}
+		return os.str();
+	}
+
+	crafter::recipe_store read(const std::string& text, unsigned threads) {
+		crafter::recipe_store recipes;
+		std::istringstream in{text};
+		crafter::read_in(in, recipes, threads);
+		return recipes;
+	}
+
+	// Enough plain recipes that the file is split into chunks
+	std::string filler(size_t count) {
+		std::string text;
+		for (size_t i = 0; i < count; i++) {
+			auto name = "Item " + std::to_string(i);
+			text += name + ":\n  makes: 2\n  ingredients:\n    - name: Part " + std::to_string(i) + "\n      count: 3\n";
+		}
+		return text;
+	}
+
+	void split_plain() {
+		std::string text = "a:\n  makes: 2\n# comment\n'b c': 1\n\"d\": [1, 2]\n";
+		auto found = crafter::split_top_level(text);
+		check(found.has_value(), "plain document splits");
+		if (!found) {
+			return;
+		}
+		check(found->size() == 3, "plain document has three entries");
+		check((*found)[0].key == "a" && (*found)[1].key == "b c" && (*found)[2].key == "d", "plain document keys");
+		check((*found)[0].end == (*found)[1].begin && (*found)[2].end == text.size(), "plain document ranges");
+	}
+
+	void split_open() {
+		check(!crafter::split_top_level("a:\n  note: \"foo\nb: 1\"\n"), "double quoted scalar over lines");
+		check(!crafter::split_top_level("a:\n  note: 'it''s\nb: 1'\n"), "single quoted scalar over lines");
+		check(!crafter::split_top_level("a: [1,\nb: 2]\n"), "flow sequence over lines");
+		check(!crafter::split_top_level("a: {x: 1,\nb: 2}\n"), "flow map over lines");
+		check(crafter::split_top_level("a:\n  method: Engineer's Workbench\nb: 1\n").has_value(), "apostrophe in a plain scalar");
+		check(crafter::split_top_level("a: \"x # y\" # 'z\nb: 1\n").has_value(), "quote in a comment");
+	}
+
+	// A quoted scalar running over a line that looks like a key must not
+	// invent a recipe when the file is read in chunks
+	void chunks_quoted() {
+		// Padded so the halfway point falls inside the scalar, and B is where
+		// a two chunk split would start
+		std::string pad;
+		for (int i = 0; i < 1700; i++) {
+			pad += "  pad pad pad pad\n";
+		}
+		auto text = "A:\n  note: \"foo\n" + pad + "B:\n  makes: 3\n  note: bar\"\n" + filler(400);
+		auto serial = read(text, 1);
+		auto chunked = read(text, 2);
+		check(serial.size() == 401 && serial.count("B") == 0, "serial parse has no B");
+		check(describe(serial) == describe(chunked), "chunked parse of a quoted scalar matches serial");
+	}
+
+	void chunks_plain() {
+		auto text = filler(2000);
+		auto serial = read(text, 1);
+		auto chunked = read(text, 4);
+		check(serial.size() == 2000, "serial parse of plain recipes");
+		check(describe(serial) == describe(chunked), "chunked parse of plain recipes matches serial");
+	}
+
+	// A quoted scalar running over a key-like line gives the same error as
+	// read_in rather than an invented recipe
+	void lazy_quoted() {
+		std::string text = "a:\n  makes: \"2\nb: 3\"\n";
+		bool serial_threw = false;
+		try {
+			read(text, 1);
+		} catch (...) {
+			serial_threw = true;
+		}
+		bool lazy_threw = false;
+		crafter::lazy_recipes lazy;
+		try {
+			lazy.add(text);
+		} catch (...) {
+			lazy_threw = true;
+		}
+		check(serial_threw, "read_in rejects a quoted makes");
+		check(lazy_threw, "lazy_recipes rejects a quoted makes");
+		check(!lazy.contains("b"), "lazy_recipes invents no recipe");
+	}
+
+	void lazy_plain() {
+		auto text = filler(50);
+		auto serial = read(text, 1);
+		crafter::lazy_recipes lazy;
+		lazy.add(text);
+		check(lazy.size() == serial.size(), "lazy_recipes indexes every recipe");
+		check(lazy.contains("Item 7") && !lazy.contains("Part 7"), "lazy_recipes knows recipe names only");
+		check(lazy.loaded().empty(), "lazy_recipes parses nothing up front");
+		auto found = lazy.find("Item 7");
+		check(found != nullptr && (*found)[0].makes == 2 && (*found)[0].ingredients[0].name == "Part 7", "lazy_recipes parses a recipe on lookup");
+		check(lazy.loaded().size() == 1, "lazy_recipes parses only what's looked up");
+	}
+}
+
+int main() {
+	split_plain();
+	split_open();
+	chunks_quoted();
+	chunks_plain();
+	lazy_quoted();
+	lazy_plain();
+	return crafter::testing::result();
+}
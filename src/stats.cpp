@@ -0,0 +1,145 @@
+#include "stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <utility>
+#include <vector>
+#include <sys/resource.h>
+
+#include "hash.h"
+
+namespace {
+	struct phase_record {
+		std::string name;
+		int64_t wall_ns;
+		int64_t cpu_ns;
+		uint64_t allocations;
+		uint64_t allocated_bytes;
+		uint64_t frees;
+		uint64_t probes;
+	};
+
+	bool stats_enabled = false;
+	std::vector<phase_record> phases;
+	std::vector<std::pair<std::string, uint64_t>> counters;
+
+	int64_t wall_now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	int64_t cpu_now() {
+		timespec now;
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+		return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+	}
+
+	void write_ms(std::ostream& os, int64_t ns) {
+		os << ns / 1000000 << "." << ns / 100000 % 10 << ns / 10000 % 10 << ns / 1000 % 10;
+	}
+}
+
+namespace crafter::stats {
+	void enable(bool on) {
+		stats_enabled = on;
+		count_allocations(on);
+		crafter::count_hash_probes.store(on, std::memory_order_relaxed);
+	}
+
+	void count_allocations(bool on) {
+		detail::counting.store(on, std::memory_order_relaxed);
+	}
+
+	bool enabled() {
+		return stats_enabled;
+	}
+
+	void enable_from_env() {
+		const char* value = std::getenv("CRAFTER_STATS");
+		if (value != nullptr && std::string_view(value) != "" && std::string_view(value) != "0") {
+			enable();
+		}
+	}
+
+	Phase::Phase(std::string_view name) : active_{stats_enabled} {
+		if (!active_) {
+			return;
+		}
+		name_ = name;
+		allocations_start_ = allocations();
+		bytes_start_ = allocated_bytes();
+		frees_start_ = frees();
+		probes_start_ = crafter::hash_probes.load(std::memory_order_relaxed);
+		cpu_start_ = cpu_now();
+		wall_start_ = wall_now();
+	}
+
+	Phase::~Phase() {
+		if (!active_) {
+			return;
+		}
+		auto wall = wall_now() - wall_start_;
+		auto cpu = cpu_now() - cpu_start_;
+		phases.push_back(phase_record{
+			std::move(name_), wall, cpu,
+			allocations() - allocations_start_,
+			allocated_bytes() - bytes_start_,
+			frees() - frees_start_,
+			crafter::hash_probes.load(std::memory_order_relaxed) - probes_start_});
+	}
+
+	void counter(std::string_view name, uint64_t value) {
+		if (!stats_enabled) {
+			return;
+		}
+		auto found = std::find_if(counters.begin(), counters.end(), [&](const auto& it) { return it.first == name; });
+		if (found != counters.end()) {
+			found->second += value;
+		} else {
+			counters.emplace_back(name, value);
+		}
+	}
+
+	uint64_t allocations() {
+		return detail::allocation_count.load(std::memory_order_relaxed);
+	}
+
+	uint64_t allocated_bytes() {
+		return detail::allocation_bytes.load(std::memory_order_relaxed);
+	}
+
+	uint64_t frees() {
+		return detail::free_count.load(std::memory_order_relaxed);
+	}
+
+	void report(std::ostream& os) {
+		if (!stats_enabled) {
+			return;
+		}
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		os << "{\"phases\":[";
+		for (size_t i = 0; i < phases.size(); i++) {
+			const auto& phase = phases[i];
+			os << (i ? "," : "") << "{\"name\":\"" << phase.name << "\",\"wall_ms\":";
+			write_ms(os, phase.wall_ns);
+			os << ",\"cpu_ms\":";
+			write_ms(os, phase.cpu_ns);
+			os << ",\"allocations\":" << phase.allocations
+			   << ",\"allocated_bytes\":" << phase.allocated_bytes
+			   << ",\"frees\":" << phase.frees
+			   << ",\"hash_probes\":" << phase.probes << "}";
+		}
+		os << "],\"counters\":{";
+		for (size_t i = 0; i < counters.size(); i++) {
+			os << (i ? "," : "") << "\"" << counters[i].first << "\":" << counters[i].second;
+		}
+		os << "},\"allocations\":" << allocations()
+		   << ",\"allocated_bytes\":" << allocated_bytes()
+		   << ",\"frees\":" << frees()
+		   << ",\"peak_rss_kb\":" << usage.ru_maxrss << "}\n";
+	}
+}
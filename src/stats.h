@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Opt in profiling for the client, enabled with --stats or CRAFTER_STATS=1.
+// Phases record wall and cpu time along with the allocations, allocated
+// bytes, frees and hash probes made while they ran, report() prints
+// everything as JSON
+namespace crafter::stats {
+	void enable(bool on = true);
+	bool enabled();
+	// Turns stats on if CRAFTER_STATS is set to anything but 0
+	void enable_from_env();
+
+	class Phase {
+	public:
+		explicit Phase(std::string_view name);
+		Phase(const Phase&) = delete;
+		Phase& operator=(const Phase&) = delete;
+		~Phase();
+	private:
+		bool active_;
+		std::string name_;
+		int64_t wall_start_ = 0;
+		int64_t cpu_start_ = 0;
+		uint64_t allocations_start_ = 0;
+		uint64_t bytes_start_ = 0;
+		uint64_t frees_start_ = 0;
+		uint64_t probes_start_ = 0;
+	};
+
+	// Repeated names add up, so a batch reports totals over its documents
+	void counter(std::string_view name, uint64_t value);
+	// Totals from the counting global allocator in the alloc_counter
+	// library. They only move while counting is on, which enable() turns
+	// on, and stay 0 in binaries without that library
+	void count_allocations(bool on = true);
+	uint64_t allocations();
+	uint64_t allocated_bytes();
+	uint64_t frees();
+	void report(std::ostream& os);
+
+	namespace detail {
+		// Read by the allocator on every allocation
+		inline std::atomic<bool> counting{false};
+		inline std::atomic<uint64_t> allocation_count{0};
+		inline std::atomic<uint64_t> allocation_bytes{0};
+		inline std::atomic<uint64_t> free_count{0};
+	}
+}
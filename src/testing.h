@@ -0,0 +1,51 @@
+#pragma once
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Shared harness for the test binaries. A failed check is reported and
+// counted rather than stopping the run, main returns result()
+namespace crafter::testing {
+	inline int failures = 0;
+
+	inline void check(bool ok, const std::string& what) {
+		if (!ok) {
+			std::cerr << "FAILED: " << what << "\n";
+			failures++;
+		}
+	}
+
+	// Whether op throws anything derived from std::exception
+	template <typename Op>
+	bool throws(Op op) {
+		try {
+			op();
+		} catch (const std::exception&) {
+			return true;
+		}
+		return false;
+	}
+
+	// Randomized comparison against a reference, run once for each of the
+	// seeds 1 to count. run gets a generator for the seed and returns
+	// whether the two sides agreed
+	template <typename Run>
+	void check_seeds(unsigned count, const std::string& what, Run run) {
+		for (unsigned seed = 1; seed <= count; seed++) {
+			std::mt19937 rng{seed};
+			check(run(rng), what + ", seed " + std::to_string(seed));
+		}
+	}
+
+	// Summary line, and the exit code for main
+	inline int result() {
+		if (failures != 0) {
+			std::cerr << failures << " checks failed\n";
+			return 1;
+		}
+		std::cout << "All checks passed\n";
+		return 0;
+	}
+}
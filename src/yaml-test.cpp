@@ -0,0 +1,486 @@
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "exp.h"
+#include "hashtable.h"
+#include "testing.h"
+#include "tokenqueue.h"
+#include "yaml-cpp/yaml.h"
+
+// Checks for the parts of the vendored yaml-cpp changed for speed, each
+// against the code it replaced
+namespace {
+	using crafter::testing::check;
+
+	// Text full of the characters the matchers look at
+	std::string random_text(std::mt19937& rng, size_t max_size) {
+		static const std::string alphabet = " \t\n\r-?:,[]{}#&*!|>'\"%@`.\\a0";
+		std::string text;
+		auto size = rng() % (max_size + 1);
+		for (size_t i = 0; i < size; i++) {
+			text += alphabet[rng() % alphabet.size()];
+		}
+		return text;
+	}
+
+	struct matcher_pair {
+		const char* name;
+		YAML::RegEx slow;
+		YAML::Exp::Fast::Matcher fast;
+	};
+
+	// Each Exp::Fast matcher gives the same match length as its RegEx
+	bool fast_matchers(std::mt19937& rng) {
+		using namespace YAML::Exp;
+		const std::vector<matcher_pair> matchers{
+			{"Empty", Empty(), Fast::Empty()},
+			{"Blank", Blank(), Fast::Blank()},
+			{"Tab", Tab(), Fast::Tab()},
+			{"Break", Break(), Fast::Break()},
+			{"BlankOrBreak", BlankOrBreak(), Fast::BlankOrBreak()},
+			{"Comment", Comment(), Fast::Comment()},
+			{"DocStart", DocStart(), Fast::DocStart()},
+			{"DocEnd", DocEnd(), Fast::DocEnd()},
+			{"DocIndicator", DocIndicator(), Fast::DocIndicator()},
+			{"BlockEntry", BlockEntry(), Fast::BlockEntry()},
+			{"Key", Key(), Fast::Key()},
+			{"KeyInFlow", KeyInFlow(), Fast::KeyInFlow()},
+			{"Value", Value(), Fast::Value()},
+			{"ValueInFlow", ValueInFlow(), Fast::ValueInFlow()},
+			{"ValueInJSONFlow", ValueInJSONFlow(), Fast::ValueInJSONFlow()},
+			{"EndScalarInFlow", EndScalarInFlow(), Fast::EndScalarInFlow()},
+			{"ScanScalarEnd", ScanScalarEnd(), Fast::ScanScalarEnd()},
+			{"ScanScalarEndInFlow", ScanScalarEndInFlow(), Fast::ScanScalarEndInFlow()},
+			{"EscBreak", EscBreak(), Fast::EscBreak()},
+			{"Anchor", Anchor(), Fast::Anchor()},
+			{"AnchorEnd", AnchorEnd(), Fast::AnchorEnd()},
+			{"PlainScalar", PlainScalar(), Fast::PlainScalar()},
+			{"PlainScalarInFlow", PlainScalarInFlow(), Fast::PlainScalarInFlow()},
+			{"SingleQuoteEnd", YAML::RegEx('\'') & !EscSingleQuote(), Fast::SingleQuoteEnd()},
+			{"DoubleQuoteEnd", YAML::RegEx('"'), Fast::DoubleQuoteEnd()},
+		};
+		bool same = true;
+		for (int i = 0; i < 2000; i++) {
+			auto text = random_text(rng, 5);
+			for (const auto& matcher : matchers) {
+				std::istringstream in{text};
+				YAML::Stream stream{in};
+				if (matcher.slow.Match(stream) != matcher.fast.Match(stream)) {
+					check(false, std::string("Exp::Fast::") + matcher.name + " on \"" + text + "\"");
+					same = false;
+				}
+			}
+		}
+		return same;
+	}
+
+	// ScalarText skips exactly the characters the table doesn't stop at,
+	// including across the 16 byte blocks
+	bool scalar_text(std::mt19937& rng) {
+		auto stops = [](unsigned char c) { return c <= ' ' || std::string_view("\"',:?[\\]{}").find(static_cast<char>(c)) != std::string_view::npos; };
+		bool same = true;
+		for (int i = 0; i < 5000 && same; i++) {
+			std::string text(rng() % 70, 'a');
+			for (auto& c : text) {
+				// Mostly plain text, so runs are long enough to cross blocks
+				c = rng() % 20 == 0 ? static_cast<char>(rng() % 256) : static_cast<char>('a' + rng() % 26);
+			}
+			size_t expected = 0;
+			while (expected < text.size() && !stops(static_cast<unsigned char>(text[expected]))) {
+				expected++;
+			}
+			same = YAML::Exp::Fast::ScalarText(text.data(), text.data() + text.size()) == expected;
+		}
+		return same;
+	}
+
+	// TokenQueue against the std::queue<Token> it replaced. Recycled slots
+	// come back reset, and queued tokens never move while the ring grows
+	bool token_queue(std::mt19937& rng) {
+		YAML::TokenQueue queue;
+		std::deque<YAML::Token> expected;
+		std::deque<const YAML::Token*> addresses;
+		bool same = true;
+		for (int i = 0; i < 20000 && same; i++) {
+			if (rng() % 5 < 3 || expected.empty()) {
+				auto type = static_cast<YAML::Token::TYPE>(rng() % (YAML::Token::NON_PLAIN_SCALAR + 1));
+				YAML::Mark mark;
+				mark.pos = i;
+				auto& token = queue.push(type, mark);
+				same = token.status == YAML::Token::VALID && token.value.empty() && token.params.empty() && token.data == 0;
+				expected.emplace_back(type, mark);
+				// Long values, so a reused buffer would show if not cleared
+				token.value = expected.back().value = std::string(rng() % 40, static_cast<char>('a' + i % 26));
+				if (rng() % 4 == 0) {
+					token.params.push_back("param");
+					expected.back().params.push_back("param");
+				}
+				token.data = expected.back().data = static_cast<int>(rng() % 3);
+				addresses.push_back(&token);
+			} else {
+				queue.pop();
+				expected.pop_front();
+				addresses.pop_front();
+			}
+			same = same && queue.size() == expected.size() && queue.empty() == expected.empty();
+			if (same && !expected.empty()) {
+				const auto& front = queue.front();
+				const auto& back = queue.back();
+				same = &front == addresses.front() && &back == addresses.back();
+				same = same && front.type == expected.front().type && front.mark.pos == expected.front().mark.pos &&
+				       front.value == expected.front().value && front.params == expected.front().params && front.data == expected.front().data;
+				same = same && back.type == expected.back().type && back.value == expected.back().value;
+			}
+		}
+		return same;
+	}
+
+	// Random operations against std::unordered_map, over keys which share
+	// their low bits the way pointers do
+	bool hash_table(std::mt19937& rng) {
+		YAML::HashTable<const int*, int> table;
+		std::unordered_map<const int*, int> expected;
+		static int targets[4096];
+		bool same = true;
+		for (int i = 0; i < 20000 && same; i++) {
+			const int* key = &targets[(rng() % 512) * 8];
+			switch (rng() % 8) {
+			case 0:
+				if (rng() % 50 == 0) {
+					table.clear();
+					expected.clear();
+				}
+				break;
+			case 1:
+				table.reserve(expected.size() + rng() % 100);
+				break;
+			case 2:
+			case 3:
+			case 4: {
+				auto value = static_cast<int>(rng());
+				table[key] = value;
+				expected[key] = value;
+				break;
+			}
+			default: {
+				const auto* found = table.find(key);
+				auto it = expected.find(key);
+				same = (found == nullptr) == (it == expected.end()) && (found == nullptr || *found == it->second);
+				break;
+			}
+			}
+			same = same && table.size() == expected.size() && table.empty() == expected.empty();
+		}
+		for (const auto& it : expected) {
+			const auto* found = table.find(it.first);
+			same = same && found != nullptr && *found == it.second;
+		}
+		return same;
+	}
+
+	// The emitter's to_chars output for one integer against the stream
+	// formatting it replaced, which prints negatives in hex and octal as
+	// the bits of the value
+	template <typename T>
+	bool integer_like_stream(T value) {
+		bool same = true;
+		for (auto base : {YAML::Dec, YAML::Hex, YAML::Oct}) {
+			std::ostringstream expected;
+			if (base == YAML::Hex) {
+				expected << "0x" << std::hex;
+			} else if (base == YAML::Oct) {
+				expected << "0" << std::oct;
+			}
+			expected << value;
+			YAML::Emitter out;
+			out << base << value;
+			same = same && expected.str() == out.c_str();
+		}
+		return same;
+	}
+
+	bool emitter_integers(std::mt19937& rng) {
+		std::mt19937_64 wide{rng()};
+		bool same = integer_like_stream(std::numeric_limits<long long>::min()) && integer_like_stream(std::numeric_limits<int>::min()) &&
+		            integer_like_stream(0) && integer_like_stream(-1);
+		for (int i = 0; i < 2000 && same; i++) {
+			// Mostly small values, so every digit count comes up
+			auto bits = wide() >> (wide() % 64);
+			same = integer_like_stream(static_cast<long long>(bits)) && integer_like_stream(-static_cast<long long>(bits)) &&
+			       integer_like_stream(static_cast<int>(bits)) && integer_like_stream(static_cast<short>(bits)) &&
+			       integer_like_stream(static_cast<unsigned>(bits)) && integer_like_stream(static_cast<unsigned long long>(bits));
+		}
+		return same;
+	}
+
+	// precision is the emitter's setting, or -1 to leave its default
+	template <typename T>
+	bool float_like_stream(T value, int precision) {
+		YAML::Emitter out;
+		if (precision >= 0) {
+			out << YAML::Precision(precision);
+		}
+		out << value;
+		std::ostringstream expected;
+		if (std::isnan(value)) {
+			expected << ".nan";
+		} else if (std::isinf(value)) {
+			expected << (value > 0 ? ".inf" : "-.inf");
+		} else {
+			// The emitter keeps its default for more digits than T has
+			auto digits = std::numeric_limits<T>::max_digits10;
+			expected.precision(precision >= 0 && precision <= digits ? precision : digits);
+			expected << value;
+		}
+		return expected.str() == out.c_str();
+	}
+
+	bool emitter_floats(std::mt19937& rng) {
+		std::uniform_int_distribution<int> exponent{-40, 40};
+		std::uniform_real_distribution<double> mantissa{-10, 10};
+		bool same = float_like_stream(std::numeric_limits<double>::quiet_NaN(), -1) && float_like_stream(std::numeric_limits<double>::infinity(), -1) &&
+		            float_like_stream(-std::numeric_limits<float>::infinity(), -1) && float_like_stream(0.0, -1) && float_like_stream(-0.0f, -1);
+		for (int i = 0; i < 2000 && same; i++) {
+			auto value = std::ldexp(mantissa(rng), exponent(rng));
+			// Whole numbers too, which print without a point
+			if (rng() % 8 == 0) {
+				value = std::round(value);
+			}
+			auto precision = static_cast<int>(rng() % 19) - 1;
+			same = float_like_stream(value, precision) && float_like_stream(static_cast<float>(value), precision);
+		}
+		return same;
+	}
+
+	// Mostly printable ASCII with the quoting characters, and now and then
+	// a control character or some UTF-8
+	std::string random_scalar(std::mt19937& rng, bool printable) {
+		static const std::string alphabet = "ab #:-,?[]{}'\"\\";
+		static const std::vector<std::string> others{"\n", "\t", "\r", "\x01", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80"};
+		std::string text;
+		auto size = rng() % 12;
+		for (size_t i = 0; i < size; i++) {
+			if (!printable && rng() % 6 == 0) {
+				text += others[rng() % others.size()];
+			} else if (rng() % 2 == 0) {
+				text += static_cast<char>('c' + rng() % 20);
+			} else {
+				text += alphabet[rng() % alphabet.size()];
+			}
+		}
+		return text;
+	}
+
+	// IsValidPlainScalar without the IsPlainAscii shortcut, in block context
+	bool plain_by_regex(const std::string& text) {
+		using namespace YAML::Exp;
+		if (text.empty() || text == "~" || text == "null" || text == "Null" || text == "NULL" || !PlainScalar().Matches(text) || text.back() == ' ') {
+			return false;
+		}
+		static const YAML::RegEx disallowed = EndScalar() | (BlankOrBreak() + Comment()) | NotPrintable() | Utf8_ByteOrderMark() | Break() | Tab();
+		for (size_t i = 0; i < text.size(); i++) {
+			if (disallowed.Matches(text.substr(i))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::string emitted(const std::string& text, YAML::EMITTER_MANIP format) {
+		YAML::Emitter out;
+		out << format << text;
+		return out.c_str();
+	}
+
+	// Plain, single and double quoted strings come out as the per code point
+	// writer made them, and every format loads back as the same string
+	bool emitter_strings(std::mt19937& rng) {
+		bool same = true;
+		for (int i = 0; i < 2000 && same; i++) {
+			auto text = random_scalar(rng, true);
+			auto plain = emitted(text, YAML::Auto);
+			same = (plain == text) == plain_by_regex(text);
+			std::string single = "'";
+			for (char c : text) {
+				single += c == '\'' ? std::string("''") : std::string(1, c);
+			}
+			same = same && emitted(text, YAML::SingleQuoted) == single + "'";
+			std::string quoted = "\"";
+			for (char c : text) {
+				quoted += c == '"' || c == '\\' ? std::string{'\\', c} : std::string(1, c);
+			}
+			same = same && emitted(text, YAML::DoubleQuoted) == quoted + "\"";
+
+			auto mixed = random_scalar(rng, false);
+			for (auto format : {YAML::Auto, YAML::SingleQuoted, YAML::DoubleQuoted}) {
+				same = same && YAML::Load(emitted(mixed, format)).as<std::string>() == mixed;
+			}
+			// A literal indents every line, and isn't always loaded back the
+			// same, so it's compared byte for byte
+			auto literal = emitted(mixed, YAML::Literal);
+			if (literal[0] == '|') {
+				std::string lines = "|\n  ";
+				for (char c : mixed) {
+					lines += c == '\n' ? std::string("\n  ") : std::string(1, c);
+				}
+				same = same && literal == lines;
+			} else {
+				same = same && YAML::Load(literal).as<std::string>() == mixed;
+			}
+		}
+		return same;
+	}
+
+	// ostream_wrapper's row, column and comment state after each write,
+	// against stepping through the characters one at a time
+	bool ostream_position(std::mt19937& rng) {
+		YAML::ostream_wrapper out;
+		std::string written;
+		size_t row = 0, col = 0;
+		bool comment = false;
+		bool same = true;
+		for (int i = 0; i < 2000 && same; i++) {
+			if (rng() % 10 == 0) {
+				out.set_comment();
+				comment = true;
+			}
+			std::string chunk(rng() % 20, 'a');
+			for (auto& c : chunk) {
+				c = rng() % 5 == 0 ? '\n' : static_cast<char>('a' + rng() % 26);
+			}
+			out.write(chunk);
+			written += chunk;
+			for (char c : chunk) {
+				col++;
+				if (c == '\n') {
+					row++;
+					col = 0;
+					comment = false;
+				}
+			}
+			same = out.pos() == written.size() && out.row() == row && out.col() == col && out.comment() == comment;
+		}
+		return same && std::string(out.str(), out.pos()) == written;
+	}
+
+	// A random document of nested maps and sequences, read back through
+	// the parser so its nodes are laid out the way loaded files are
+	YAML::Node random_document(std::mt19937& rng, int depth = 0) {
+		static const std::vector<std::string> words{"a", "b", "name", "count", "1", "~", "x y", ""};
+		YAML::Node node;
+		switch (depth < 3 ? rng() % 4 : 0) {
+		case 0:
+			node = words[rng() % words.size()];
+			break;
+		case 1:
+			node = YAML::Node(YAML::NodeType::Null);
+			break;
+		case 2:
+			for (auto size = rng() % 4; size > 0; size--) {
+				node.push_back(random_document(rng, depth + 1));
+			}
+			break;
+		default:
+			for (auto size = rng() % 5; size > 0; size--) {
+				node[words[rng() % words.size()]] = random_document(rng, depth + 1);
+			}
+			break;
+		}
+		return depth == 0 ? YAML::Load(YAML::Dump(node)) : node;
+	}
+
+	// A view reads the same as the node it was taken from, all the way down
+	bool same_tree(const YAML::NodeView& view, const YAML::Node& node) {
+		if (view.Type() != node.Type() || view.IsDefined() != node.IsDefined() || view.size() != node.size() || view.Tag() != node.Tag()) {
+			return false;
+		}
+		if (node.IsScalar()) {
+			return view.Scalar() == node.Scalar() && view.as<std::string>() == node.as<std::string>();
+		}
+		auto it = view.begin();
+		for (const auto& item : node) {
+			if (it == view.end()) {
+				return false;
+			}
+			if (node.IsMap()) {
+				if (!same_tree(it->first, item.first) || !same_tree(it->second, item.second) ||
+				    !same_tree(view[item.first.Scalar()], node[item.first.Scalar()])) {
+					return false;
+				}
+			} else if (!same_tree(*it, item)) {
+				return false;
+			}
+			++it;
+		}
+		return it == view.end();
+	}
+
+	bool view_matches_node(std::mt19937& rng) {
+		bool same = true;
+		for (int i = 0; i < 300 && same; i++) {
+			const auto doc = random_document(rng);
+			const YAML::NodeView view{doc};
+			same = same_tree(view, doc);
+			// Indexing a scalar throws, as it does for a const Node
+			if (doc.IsScalar()) {
+				same = same && crafter::testing::throws([&] { return view["a"]; });
+			}
+		}
+		return same;
+	}
+
+	// find() on a Node and on a view gives the value for a present key and
+	// an undefined view for a missing one, and the document is unchanged
+	// after, unlike with a non-const operator[]
+	bool find_adds_nothing(std::mt19937& rng) {
+		static const std::vector<std::string> keys{"a", "b", "name", "count", "1", "~", "x y", "", "missing"};
+		bool same = true;
+		for (int i = 0; i < 300 && same; i++) {
+			auto doc = random_document(rng);
+			if (!doc.IsMap()) {
+				continue;
+			}
+			const auto before = YAML::Dump(doc);
+			for (const auto& key : keys) {
+				YAML::Node value{YAML::NodeType::Undefined};
+				for (const auto& pair : doc) {
+					if (pair.first.Scalar() == key) {
+						value = pair.second;
+					}
+				}
+				auto found = doc.find(key);
+				same = same && found.IsDefined() == value.IsDefined() && doc.find(key.c_str()).IsDefined() == found.IsDefined();
+				same = same && YAML::NodeView(doc).find(key).IsDefined() == found.IsDefined();
+				if (value.IsDefined()) {
+					same = same && same_tree(found, value);
+				} else {
+					same = same && !found.find("a") && found.as<int>(7) == 7;
+				}
+			}
+			same = same && YAML::Dump(doc) == before;
+		}
+		auto scalar = YAML::Load("text");
+		return same && crafter::testing::throws([&] { return scalar.find("a"); }) && !YAML::NodeView().find("a");
+	}
+}
+
+int main() {
+	crafter::testing::check_seeds(5, "Exp::Fast matchers match their RegEx", fast_matchers);
+	crafter::testing::check_seeds(5, "ScalarText matches a character loop", scalar_text);
+	crafter::testing::check_seeds(5, "TokenQueue matches a queue of tokens", token_queue);
+	crafter::testing::check_seeds(5, "HashTable matches std::unordered_map", hash_table);
+	crafter::testing::check_seeds(5, "Emitted integers match the stream output", emitter_integers);
+	crafter::testing::check_seeds(5, "Emitted floats match the stream output", emitter_floats);
+	crafter::testing::check_seeds(5, "Emitted strings match the per character writer", emitter_strings);
+	crafter::testing::check_seeds(5, "ostream_wrapper tracks its position", ostream_position);
+	crafter::testing::check_seeds(5, "NodeView reads the same as Node", view_matches_node);
+	crafter::testing::check_seeds(5, "find looks up keys without adding them", find_adds_nothing);
+	return crafter::testing::result();
+}
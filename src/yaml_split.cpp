@@ -0,0 +1,167 @@
+#include "yaml_split.h"
+
+#include <algorithm>
+#include <istream>
+#include <streambuf>
+
+namespace {
+	constexpr std::string_view indicators = "-?:,[]{}#&*!|>'\"%@`";
+
+	// Whether an anchor, alias or tag could start anywhere in the text,
+	// these can tie one top level entry to another
+	bool has_node_property(std::string_view text) {
+		for (size_t i = text.find_first_of("&*!"); i != std::string_view::npos; i = text.find_first_of("&*!", i + 1)) {
+			if (i == 0 || std::string_view(" \t\r\n[{,").find(text[i - 1]) != std::string_view::npos) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	class view_buffer : public std::streambuf {
+	public:
+		explicit view_buffer(std::string_view text) {
+			auto begin = const_cast<char*>(text.data());
+			setg(begin, begin, begin + text.size());
+		}
+	};
+
+	bool is_blank(char c) {
+		return c == ' ' || c == '\t';
+	}
+
+	// Reads the key of a top level entry starting at the beginning of the
+	// line, false if it isn't a key that can be read without a parser
+	bool read_key(std::string_view line, std::string& key) {
+		key.clear();
+		size_t colon;
+		if (line[0] == '\'' || line[0] == '"') {
+			auto quote = line[0];
+			size_t i = 1;
+			for (;; i++) {
+				if (i == line.size() || (quote == '"' && line[i] == '\\')) {
+					return false;
+				}
+				if (line[i] == quote) {
+					if (quote == '\'' && i + 1 < line.size() && line[i + 1] == '\'') {
+						key += '\'';
+						i++;
+						continue;
+					}
+					break;
+				}
+				key += line[i];
+			}
+			colon = i + 1;
+			while (colon < line.size() && is_blank(line[colon])) {
+				colon++;
+			}
+			if (colon == line.size() || line[colon] != ':') {
+				return false;
+			}
+		} else {
+			if (is_blank(line[0]) || indicators.find(line[0]) != std::string_view::npos || line.substr(0, 3) == "...") {
+				return false;
+			}
+			for (colon = 0;; colon++) {
+				if (colon == line.size() || (line[colon] == '#' && is_blank(line[colon - 1]))) {
+					return false;
+				}
+				if (line[colon] == ':' && (colon + 1 == line.size() || is_blank(line[colon + 1]))) {
+					break;
+				}
+			}
+			auto end = colon;
+			while (is_blank(line[end - 1])) {
+				end--;
+			}
+			key = line.substr(0, end);
+		}
+		return colon + 1 == line.size() || is_blank(line[colon + 1]);
+	}
+
+	// Whether a quoted scalar or flow collection started on the line is
+	// still open at its end. Then the next lines belong to it, even the
+	// ones which look like keys in column 0. Quotes and brackets inside a
+	// plain scalar can be taken as opening one, which only costs a split
+	bool left_open(std::string_view line) {
+		char quote = 0;
+		int depth = 0;
+		for (size_t i = 0; i < line.size(); i++) {
+			auto c = line[i];
+			if (quote == '"') {
+				if (c == '\\') {
+					i++;
+				} else if (c == '"') {
+					quote = 0;
+				}
+				continue;
+			}
+			if (quote == '\'') {
+				if (c == '\'' && i + 1 < line.size() && line[i + 1] == '\'') {
+					i++;
+				} else if (c == '\'') {
+					quote = 0;
+				}
+				continue;
+			}
+			bool token_start = i == 0 || is_blank(line[i - 1]) || std::string_view("[{,:").find(line[i - 1]) != std::string_view::npos;
+			if (c == '#' && (i == 0 || is_blank(line[i - 1]))) {
+				break;
+			}
+			if ((c == '\'' || c == '"') && token_start) {
+				quote = c;
+			} else if ((c == '[' || c == '{') && token_start) {
+				depth++;
+			} else if ((c == ']' || c == '}') && depth > 0) {
+				depth--;
+			}
+		}
+		return quote != 0 || depth > 0;
+	}
+}
+
+namespace crafter {
+	std::optional<std::vector<top_level_entry>> split_top_level(std::string_view text) {
+		// Any UTF-16 or UTF-32 text has zero bytes, leave those to the parser
+		if (has_node_property(text) || text.find('\0') != std::string_view::npos) {
+			return std::nullopt;
+		}
+		std::vector<top_level_entry> found;
+		std::string key;
+		size_t pos = text.substr(0, 3) == "\xEF\xBB\xBF" ? 3 : 0;
+		while (pos < text.size()) {
+			auto eol = std::min(text.find('\n', pos), text.size());
+			auto line = text.substr(pos, eol - pos);
+			if (!line.empty() && line.back() == '\r') {
+				line.remove_suffix(1);
+			}
+			auto first = line.find_first_not_of(' ');
+			if (first != std::string_view::npos && line[first] != '#') {
+				if (left_open(line)) {
+					return std::nullopt;
+				}
+				if (first == 0) {
+					if (!read_key(line, key)) {
+						return std::nullopt;
+					}
+					if (!found.empty()) {
+						found.back().end = pos;
+					}
+					found.push_back(top_level_entry{key, pos, text.size()});
+				} else if (found.empty()) {
+					// Indented content before any key, the document isn't a plain map
+					return std::nullopt;
+				}
+			}
+			pos = eol + 1;
+		}
+		return found;
+	}
+
+	YAML::Node load_view(std::string_view text) {
+		view_buffer buffer{text};
+		std::istream in{&buffer};
+		return YAML::Load(in);
+	}
+}
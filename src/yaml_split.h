@@ -0,0 +1,29 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+namespace crafter {
+	// A top level entry of a block map document, as the byte range running
+	// from its key's line up to the next key's line
+	struct top_level_entry {
+		std::string key;
+		size_t begin;
+		size_t end;
+	};
+
+	// Splits a document at the lines which start with a key in column 0.
+	// Each entry then parses on its own to the same thing it would in the
+	// whole document. nullopt for documents where that can't be known
+	// without a parser: anchors, aliases and tags, flow collections, several
+	// documents, keys which aren't plain or simply quoted, quoted scalars or
+	// flow collections left open at the end of a line, or other encodings
+	std::optional<std::vector<top_level_entry>> split_top_level(std::string_view text);
+
+	// Parses a range of text in place, without copying it into a string stream
+	YAML::Node load_view(std::string_view text);
+}
@@ -15,6 +15,13 @@
 #include <string>
 #include <type_traits>
 
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define YAML_CPP_HAS_TO_CHARS
+#endif
+#endif
+
 #include "yaml-cpp/binary.h"
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/emitterdef.h"
@@ -88,6 +95,7 @@ class YAML_CPP_API Emitter {
   std::size_t GetDoublePrecision() const;
 
   void PrepareIntegralStream(std::stringstream& stream) const;
+  int GetIntBase() const;
   void StartedScalar();
 
  private:
@@ -137,10 +145,30 @@ inline Emitter& Emitter::WriteIntegralType(T value) {
 
   PrepareNode(EmitterNodeType::Scalar);
 
+#ifdef YAML_CPP_HAS_TO_CHARS
+  // Hex and octal print the bits of negative values, as a stream does
+  const int base = GetIntBase();
+  char buffer[std::numeric_limits<T>::digits + 4];
+  char* first = buffer;
+  if (base == 16) {
+    *first++ = '0';
+    *first++ = 'x';
+  } else if (base == 8) {
+    *first++ = '0';
+  }
+  std::to_chars_result result =
+      base == 10 ? std::to_chars(first, buffer + sizeof(buffer), value)
+                 : std::to_chars(
+                       first, buffer + sizeof(buffer),
+                       static_cast<typename std::make_unsigned<T>::type>(value),
+                       base);
+  m_stream.write(buffer, static_cast<std::size_t>(result.ptr - buffer));
+#else
   std::stringstream stream;
   PrepareIntegralStream(stream);
   stream << value;
   m_stream << stream.str();
+#endif
 
   StartedScalar();
 
@@ -154,6 +182,26 @@ inline Emitter& Emitter::WriteStreamable(T value) {
 
   PrepareNode(EmitterNodeType::Scalar);
 
+#if defined(YAML_CPP_HAS_TO_CHARS) && defined(__cpp_lib_to_chars)
+  // Same digits as the stream's default %g formatting, without its locale
+  if constexpr (std::is_floating_point<T>::value) {
+    if (std::isfinite(value)) {
+      const std::size_t precision = std::is_same<T, float>::value
+                                        ? GetFloatPrecision()
+                                        : GetDoublePrecision();
+      char buffer[64];
+      std::to_chars_result result = std::to_chars(
+          buffer, buffer + sizeof(buffer), value, std::chars_format::general,
+          static_cast<int>(precision));
+      if (result.ec == std::errc()) {
+        m_stream.write(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        StartedScalar();
+        return *this;
+      }
+    }
+  }
+#endif
+
   std::stringstream stream;
   SetStreamablePrecision<T>(stream);
 
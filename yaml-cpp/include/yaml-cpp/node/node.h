@@ -26,10 +26,13 @@ struct iterator_value;
 }  // namespace YAML
 
 namespace YAML {
+class NodeView;
+
 class YAML_CPP_API Node {
  public:
   friend class NodeBuilder;
   friend class NodeEvents;
+  friend class NodeView;
   friend struct detail::iterator_value;
   friend class detail::node;
   friend class detail::node_data;
@@ -109,6 +112,11 @@ class YAML_CPP_API Node {
   Node operator[](const Node& key);
   bool remove(const Node& key);
 
+  // lookup without side effects, giving an undefined view if the key is
+  // missing. Defined in view.h.
+  NodeView find(const std::string& key) const;
+  NodeView find(const char* key) const;
+
   // map
   template <typename Key, typename Value>
   void force_insert(const Key& key, const Value& value);
@@ -15,6 +15,7 @@
 
 namespace YAML {
 class Node;
+class Parser;
 
 /**
  * Loads the input string as a single YAML document.
@@ -73,6 +74,17 @@ YAML_CPP_API std::vector<Node> LoadAll(std::istream& input);
  * @throws {@link BadFile} if the file cannot be loaded.
  */
 YAML_CPP_API std::vector<Node> LoadAllFromFile(const std::string& filename);
+
+/**
+ * Loads the parser's next YAML document into document, so a stream of
+ * documents can be read one at a time without holding them all. Like
+ * Node::reset, document is rebound rather than assigned to, so it doesn't
+ * keep the earlier documents alive.
+ *
+ * @return false, leaving document alone, if there are no more documents.
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API bool LoadNext(Parser& parser, Node& document);
 }  // namespace YAML
 
 #endif  // VALUE_PARSE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,233 @@
+#ifndef NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+namespace detail {
+struct view_iterator_value;
+class view_iterator;
+}  // namespace detail
+
+/**
+ * A borrowed, read only view of a node. It holds a plain pointer into the
+ * document rather than sharing ownership of it, so copying, indexing and
+ * iterating views never touch the memory holder's reference count. A view
+ * is only valid while a Node of the same document is alive.
+ */
+class NodeView {
+ public:
+  friend class detail::view_iterator;
+
+  using const_iterator = detail::view_iterator;
+
+  NodeView() : m_isDefined(false), m_pNode(nullptr) {}
+  explicit NodeView(const Node& node)
+      : m_isDefined(node.m_isValid),
+        m_pNode(node.m_isValid ? node.m_pNode : nullptr) {}
+
+  YAML::Mark Mark() const {
+    return m_pNode ? m_pNode->mark() : Mark::null_mark();
+  }
+  NodeType::value Type() const {
+    if (m_pNode)
+      return m_pNode->type();
+    return m_isDefined ? NodeType::Null : NodeType::Undefined;
+  }
+  bool IsDefined() const {
+    return m_pNode ? m_pNode->is_defined() : m_isDefined;
+  }
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  // bool conversions
+  explicit operator bool() const { return IsDefined(); }
+  bool operator!() const { return !IsDefined(); }
+
+  // access
+  template <typename T>
+  T as() const;
+  template <typename T, typename S>
+  T as(const S& fallback) const;
+  const std::string& Scalar() const {
+    return m_pNode ? m_pNode->scalar() : detail::node_data::empty_scalar();
+  }
+  const std::string& Tag() const {
+    return m_pNode ? m_pNode->tag() : detail::node_data::empty_scalar();
+  }
+
+  // size/iterator
+  std::size_t size() const { return m_pNode ? m_pNode->size() : 0; }
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // Map lookup by scalar key, giving an undefined view if the key is
+  // missing. Unlike Node::operator[], this never adds to the document.
+  NodeView find(const std::string& key) const { return get(key); }
+  NodeView find(const char* key) const { return get(key); }
+  NodeView operator[](const std::string& key) const { return get(key); }
+  NodeView operator[](const char* key) const { return get(key); }
+
+ private:
+  explicit NodeView(const detail::node* node)
+      : m_isDefined(true), m_pNode(node) {}
+
+  template <typename Key>
+  NodeView get(const Key& key) const;
+
+  // A Node over the same node for the convert<T> decoders. It has no memory
+  // holder, so it's only good for reading.
+  Node borrow() const {
+    return m_pNode ? Node(*const_cast<detail::node*>(m_pNode),
+                          detail::shared_memory_holder())
+                   : Node();
+  }
+
+ private:
+  bool m_isDefined;
+  const detail::node* m_pNode;
+};
+
+namespace detail {
+struct view_iterator_value : public NodeView,
+                             public std::pair<NodeView, NodeView> {
+  view_iterator_value() : NodeView(), std::pair<NodeView, NodeView>() {}
+  explicit view_iterator_value(const NodeView& rhs)
+      : NodeView(rhs), std::pair<NodeView, NodeView>() {}
+  explicit view_iterator_value(const NodeView& key, const NodeView& value)
+      : NodeView(), std::pair<NodeView, NodeView>(key, value) {}
+};
+
+class view_iterator {
+ private:
+  struct proxy {
+    explicit proxy(const view_iterator_value& x) : m_ref(x) {}
+    view_iterator_value* operator->() { return std::addressof(m_ref); }
+    operator view_iterator_value*() { return std::addressof(m_ref); }
+
+    view_iterator_value m_ref;
+  };
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = view_iterator_value;
+  using difference_type = std::ptrdiff_t;
+  using pointer = view_iterator_value*;
+  using reference = view_iterator_value;
+
+  view_iterator() : m_iterator() {}
+  explicit view_iterator(const_node_iterator rhs) : m_iterator(rhs) {}
+
+  view_iterator& operator++() {
+    ++m_iterator;
+    return *this;
+  }
+
+  view_iterator operator++(int) {
+    view_iterator iterator_pre(*this);
+    ++(*this);
+    return iterator_pre;
+  }
+
+  bool operator==(const view_iterator& rhs) const {
+    return m_iterator == rhs.m_iterator;
+  }
+
+  bool operator!=(const view_iterator& rhs) const {
+    return m_iterator != rhs.m_iterator;
+  }
+
+  value_type operator*() const {
+    const const_node_iterator::value_type v = *m_iterator;
+    if (v.pNode)
+      return value_type(NodeView(v.pNode));
+    if (v.first && v.second)
+      return value_type(NodeView(v.first), NodeView(v.second));
+    return value_type();
+  }
+
+  proxy operator->() const { return proxy(**this); }
+
+ private:
+  const_node_iterator m_iterator;
+};
+}  // namespace detail
+
+template <typename T>
+inline T NodeView::as() const {
+  if (!m_isDefined)
+    throw InvalidNode(std::string());
+  return borrow().as<T>();
+}
+
+template <typename T, typename S>
+inline T NodeView::as(const S& fallback) const {
+  if (!m_isDefined)
+    return fallback;
+  return borrow().as<T>(fallback);
+}
+
+inline NodeView::const_iterator NodeView::begin() const {
+  return m_pNode ? const_iterator(m_pNode->begin()) : const_iterator();
+}
+
+inline NodeView::const_iterator NodeView::end() const {
+  return m_pNode ? const_iterator(m_pNode->end()) : const_iterator();
+}
+
+// Matches the lookup Node::operator[] const does for a string key
+template <typename Key>
+inline NodeView NodeView::get(const Key& key) const {
+  switch (Type()) {
+    case NodeType::Map:
+      break;
+    case NodeType::Scalar:
+      throw BadSubscript(std::string(key));
+    default:
+      return NodeView();
+  }
+
+  for (detail::const_node_iterator it = m_pNode->begin(); it != m_pNode->end();
+       ++it) {
+    const detail::node& candidate = *it->first;
+    if (candidate.type() == NodeType::Scalar && candidate.scalar() == key) {
+      return NodeView(it->second);
+    }
+  }
+  return NodeView();
+}
+
+inline NodeView Node::find(const std::string& key) const {
+  if (!m_isValid)
+    throw InvalidNode(m_invalidKey);
+  return NodeView(*this).find(key);
+}
+
+inline NodeView Node::find(const char* key) const {
+  if (!m_isValid)
+    throw InvalidNode(m_invalidKey);
+  return NodeView(*this).find(key);
+}
+}  // namespace YAML
+
+#endif  // NODE_VIEW_H_62B23520_7C8E_11DE_8A39_0800200C9A66
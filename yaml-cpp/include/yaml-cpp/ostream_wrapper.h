@@ -43,7 +43,7 @@ class YAML_CPP_API ostream_wrapper {
   bool comment() const { return m_comment; }
 
  private:
-  void update_pos(char ch);
+  void update_pos(const char* str, std::size_t size);
 
  private:
   mutable std::vector<char> m_buffer;
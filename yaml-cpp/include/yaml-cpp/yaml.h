@@ -20,5 +20,6 @@
 #include "yaml-cpp/node/detail/impl.h"
 #include "yaml-cpp/node/parse.h"
 #include "yaml-cpp/node/emit.h"
+#include "yaml-cpp/node/view.h"
 
 #endif  // YAML_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -667,6 +667,17 @@ void Emitter::PrepareIntegralStream(std::stringstream& stream) const {
   }
 }
 
+int Emitter::GetIntBase() const {
+  switch (m_pState->GetIntFormat()) {
+    case Hex:
+      return 16;
+    case Oct:
+      return 8;
+    default:
+      return 10;
+  }
+}
+
 void Emitter::StartedScalar() { m_pState->StartedScalar(); }
 
 // *******************************************************************************************
@@ -151,6 +151,50 @@ void WriteCodePoint(ostream_wrapper& out, int codePoint) {
   }
 }
 
+// Writes the run of printable ASCII at 'first' up to either of the
+// characters that need escaping in one go, and moves past it
+void WritePrintableRun(ostream_wrapper& out, std::string::const_iterator& first,
+                       std::string::const_iterator last, char special1,
+                       char special2) {
+  std::string::const_iterator end = first;
+  while (end != last && 0x20 <= *end && *end <= 0x7E && *end != special1 &&
+         *end != special2) {
+    ++end;
+  }
+  if (end != first) {
+    out.write(&*first, static_cast<std::size_t>(end - first));
+    first = end;
+  }
+}
+
+// Whether none of the characters can start a match of the disallowed
+// expressions below: printable ASCII, without flow or value indicators and
+// without a blank before a '#'
+bool IsPlainAscii(const std::string& str) {
+  for (std::size_t i = 0; i < str.size(); i++) {
+    switch (str[i]) {
+      case ':':
+      case ',':
+      case '?':
+      case '[':
+      case ']':
+      case '{':
+      case '}':
+        return false;
+      case ' ':
+        if (i + 1 < str.size() && str[i + 1] == '#') {
+          return false;
+        }
+        break;
+      default:
+        if (str[i] < 0x21 || str[i] > 0x7E) {
+          return false;
+        }
+    }
+  }
+  return true;
+}
+
 bool IsValidPlainScalar(const std::string& str, FlowType::value flowType,
                         bool allowOnlyAscii) {
   // check against null
@@ -171,7 +215,10 @@ bool IsValidPlainScalar(const std::string& str, FlowType::value flowType,
     return false;
   }
 
-  // then check until something is disallowed
+  // then check until something is disallowed, unless nothing could be
+  if (IsPlainAscii(str)) {
+    return true;
+  }
   static const RegEx& disallowed_flow =
       Exp::EndScalarInFlow() | (Exp::BlankOrBreak() + Exp::Comment()) |
       Exp::NotPrintable() | Exp::Utf8_ByteOrderMark() | Exp::Break() |
@@ -292,8 +339,12 @@ StringFormat::value ComputeStringFormat(const std::string& str,
 bool WriteSingleQuotedString(ostream_wrapper& out, const std::string& str) {
   out << "'";
   int codePoint;
-  for (std::string::const_iterator i = str.begin();
-       GetNextCodePointAndAdvance(codePoint, i, str.end());) {
+  for (std::string::const_iterator i = str.begin();;) {
+    WritePrintableRun(out, i, str.end(), '\'', '\'');
+    if (!GetNextCodePointAndAdvance(codePoint, i, str.end())) {
+      break;
+    }
+
     if (codePoint == '\n') {
       return false;  // We can't handle a new line and the attendant indentation
                      // yet
@@ -313,8 +364,12 @@ bool WriteDoubleQuotedString(ostream_wrapper& out, const std::string& str,
                              bool escapeNonAscii) {
   out << "\"";
   int codePoint;
-  for (std::string::const_iterator i = str.begin();
-       GetNextCodePointAndAdvance(codePoint, i, str.end());) {
+  for (std::string::const_iterator i = str.begin();;) {
+    WritePrintableRun(out, i, str.end(), '\"', '\\');
+    if (!GetNextCodePointAndAdvance(codePoint, i, str.end())) {
+      break;
+    }
+
     switch (codePoint) {
       case '\"':
         out << "\\\"";
@@ -358,8 +413,12 @@ bool WriteLiteralString(ostream_wrapper& out, const std::string& str,
   out << "|\n";
   out << IndentTo(indent);
   int codePoint;
-  for (std::string::const_iterator i = str.begin();
-       GetNextCodePointAndAdvance(codePoint, i, str.end());) {
+  for (std::string::const_iterator i = str.begin();;) {
+    WritePrintableRun(out, i, str.end(), '\n', '\n');
+    if (!GetNextCodePointAndAdvance(codePoint, i, str.end())) {
+      break;
+    }
+
     if (codePoint == '\n') {
       out << "\n" << IndentTo(indent);
     } else {
@@ -1,5 +1,11 @@
 #include <sstream>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YAML_CPP_SSE2
+#endif
+
 #include "exp.h"
 #include "stream.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
@@ -131,5 +137,36 @@ std::string Escape(Stream& in) {
   std::stringstream msg;
   throw ParserException(in.mark(), std::string(ErrorMsg::INVALID_ESCAPE) + ch);
 }
+
+namespace Fast {
+std::size_t ScalarText(const char* begin, const char* end) {
+  const char* it = begin;
+#ifdef YAML_CPP_SSE2
+  // 16 bytes at a time until a block has a stop in it, then the table finds
+  // exactly where
+  static const char indicators[] = {'"', '\'', ',', ':', '?', '[',
+                                    '\\', ']', '{', '}'};
+  const __m128i space = _mm_set1_epi8(' ');
+  while (end - it >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+    // unsigned bytes up to ' ' are the blanks, breaks and control characters
+    __m128i stop = _mm_cmpeq_epi8(_mm_min_epu8(block, space), block);
+    for (char indicator : indicators) {
+      stop = _mm_or_si128(stop,
+                          _mm_cmpeq_epi8(block, _mm_set1_epi8(indicator)));
+    }
+    if (_mm_movemask_epi8(stop) != 0) {
+      break;
+    }
+    it += 16;
+  }
+#endif
+  while (it != end &&
+         !detail::Is(static_cast<unsigned char>(*it), detail::SCALAR_STOP)) {
+    ++it;
+  }
+  return static_cast<std::size_t>(it - begin);
+}
+}  // namespace Fast
 }  // namespace Exp
 }  // namespace YAML
@@ -7,11 +7,13 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <ios>
 #include <string>
 
 #include "regex_yaml.h"
 #include "stream.h"
+#include "streamcharsource.h"
 
 namespace YAML {
 ////////////////////////////////////////////////////////////////////////////////
@@ -200,6 +202,302 @@ inline const RegEx& Chomp() {
 
 // and some functions
 std::string Escape(Stream& in);
+
+////////////////////////////////////////////////////////////////////////////////
+// Compiled versions of the expressions the scanner tests on every character.
+// Each one gives the same result as RegEx::Match on the expression of the
+// same name above, but is a straight function over a 256 entry class table
+// and a fixed lookahead, instead of a walk over a tree of RegEx objects. The
+// RegEx versions are still used wherever expressions get combined.
+namespace Fast {
+namespace detail {
+// Character classes in the table
+constexpr unsigned BLANK = 1u << 0;
+constexpr unsigned ANCHOR_STOP = 1u << 1;        // not in an Anchor()
+constexpr unsigned ANCHOR_END = 1u << 2;
+constexpr unsigned PLAIN_STOP = 1u << 3;         // can't start a PlainScalar()
+constexpr unsigned PLAIN_FLOW_STOP = 1u << 4;    // same, in flow
+constexpr unsigned PLAIN_PREFIX = 1u << 5;       // same, before a blank
+constexpr unsigned PLAIN_FLOW_PREFIX = 1u << 6;  // same, in flow
+constexpr unsigned FLOW_END = 1u << 7;
+constexpr unsigned FLOW_VALUE_END = 1u << 8;     // after ':' in flow
+constexpr unsigned VALUE_IN_FLOW_END = 1u << 9;  // after ':' in ValueInFlow()
+constexpr unsigned SCALAR_STOP = 1u << 10;       // see ScalarText()
+
+constexpr bool In(const char* set, char ch) {
+  return *set != '\0' && (*set == ch || In(set + 1, ch));
+}
+
+constexpr unsigned ClassesOf(char ch) {
+  return (In(" \t", ch) ? BLANK : 0) | (In("[]{},", ch) ? ANCHOR_STOP : 0) |
+         (In("?:,]}%@`", ch) ? ANCHOR_END : 0) |
+         (In(",[]{}#&*!|>\'\"%@`", ch) ? PLAIN_STOP : 0) |
+         (In("?,[]{}#&*!|>\'\"%@`", ch) ? PLAIN_FLOW_STOP : 0) |
+         (In("-?:", ch) ? PLAIN_PREFIX : 0) |
+         (In("-:", ch) ? PLAIN_FLOW_PREFIX : 0) |
+         (In(",?[]{}", ch) ? FLOW_END : 0) |
+         (In(",]}", ch) ? FLOW_VALUE_END : 0) |
+         (In(",}", ch) ? VALUE_IN_FLOW_END : 0) |
+         (static_cast<unsigned char>(ch) <= ' ' || In("\"\',:?[\\]{}", ch)
+              ? SCALAR_STOP
+              : 0);
+}
+
+// The table is generated at compile time from ClassesOf
+template <std::size_t... I>
+struct Indices {};
+template <std::size_t N, std::size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <std::size_t... I>
+struct MakeIndices<0, I...> {
+  typedef Indices<I...> type;
+};
+
+template <typename>
+struct CharTable;
+template <std::size_t... I>
+struct CharTable<Indices<I...>> {
+  static constexpr unsigned classes[sizeof...(I)] = {
+      ClassesOf(static_cast<char>(I))...};
+};
+#if __cplusplus < 201703L
+template <std::size_t... I>
+constexpr unsigned CharTable<Indices<I...>>::classes[sizeof...(I)];
+#endif
+
+typedef CharTable<MakeIndices<256>::type> Table;
+
+// Character i ahead as 0-255, or -1 past the end of the readahead
+inline int Look(const StreamCharSource& source, int i) {
+  if (!(source + i)) {
+    return -1;
+  }
+  return static_cast<unsigned char>(source[i]);
+}
+
+inline bool Is(int ch, unsigned classes) {
+  return ch >= 0 && (Table::classes[ch] & classes) != 0;
+}
+
+inline bool IsEnd(int ch) {
+  return ch == static_cast<unsigned char>(Stream::eof());
+}
+
+inline int BreakAt(const StreamCharSource& source, int i) {
+  int ch = Look(source, i);
+  if (ch == '\n') {
+    return 1;
+  }
+  return ch == '\r' && Look(source, i + 1) == '\n' ? 2 : -1;
+}
+
+inline int BlankOrBreakAt(const StreamCharSource& source, int i) {
+  return Is(Look(source, i), BLANK) ? 1 : BreakAt(source, i);
+}
+
+// BlankOrBreak() | RegEx(), the usual tail after an indicator
+inline int BlankOrBreakOrEndAt(const StreamCharSource& source, int i) {
+  int ch = Look(source, i);
+  if (Is(ch, BLANK)) {
+    return 1;
+  }
+  if (IsEnd(ch)) {
+    return 0;
+  }
+  return BreakAt(source, i);
+}
+
+// An indicator character followed by some tail
+template <int (*Tail)(const StreamCharSource&, int)>
+inline int Indicator(const StreamCharSource& source, char indicator) {
+  if (Look(source, 0) != static_cast<unsigned char>(indicator)) {
+    return -1;
+  }
+  int n = Tail(source, 1);
+  return n < 0 ? -1 : n + 1;
+}
+
+inline int DocIndicator(const StreamCharSource& source, char indicator) {
+  for (int i = 0; i < 3; i++) {
+    if (Look(source, i) != static_cast<unsigned char>(indicator)) {
+      return -1;
+    }
+  }
+  int n = BlankOrBreakOrEndAt(source, 3);
+  return n < 0 ? -1 : n + 3;
+}
+
+inline int ValueInFlowTail(const StreamCharSource& source, int i) {
+  return Is(Look(source, i), VALUE_IN_FLOW_END) ? 1
+                                                : BlankOrBreakAt(source, i);
+}
+
+inline int EndScalarInFlowTail(const StreamCharSource& source, int i) {
+  return Is(Look(source, i), FLOW_VALUE_END) ? 1
+                                             : BlankOrBreakOrEndAt(source, i);
+}
+
+// Comment after a blank or break, the second half of ScanScalarEnd()
+inline int SpacedComment(const StreamCharSource& source) {
+  int n = BlankOrBreakAt(source, 0);
+  return n >= 0 && Look(source, n) == '#' ? n + 1 : -1;
+}
+
+inline int Empty(const StreamCharSource& source) {
+  return IsEnd(Look(source, 0)) ? 0 : -1;
+}
+inline int Blank(const StreamCharSource& source) {
+  return Is(Look(source, 0), BLANK) ? 1 : -1;
+}
+inline int Tab(const StreamCharSource& source) {
+  return Look(source, 0) == '\t' ? 1 : -1;
+}
+inline int Break(const StreamCharSource& source) {
+  return BreakAt(source, 0);
+}
+inline int BlankOrBreak(const StreamCharSource& source) {
+  return BlankOrBreakAt(source, 0);
+}
+inline int Comment(const StreamCharSource& source) {
+  return Look(source, 0) == '#' ? 1 : -1;
+}
+inline int DocStart(const StreamCharSource& source) {
+  return DocIndicator(source, '-');
+}
+inline int DocEnd(const StreamCharSource& source) {
+  return DocIndicator(source, '.');
+}
+inline int DocIndicator(const StreamCharSource& source) {
+  int n = DocStart(source);
+  return n >= 0 ? n : DocEnd(source);
+}
+inline int BlockEntry(const StreamCharSource& source) {
+  return Indicator<BlankOrBreakOrEndAt>(source, '-');
+}
+inline int Key(const StreamCharSource& source) {
+  return Indicator<BlankOrBreakAt>(source, '?');
+}
+inline int Value(const StreamCharSource& source) {
+  return Indicator<BlankOrBreakOrEndAt>(source, ':');
+}
+inline int ValueInFlow(const StreamCharSource& source) {
+  return Indicator<ValueInFlowTail>(source, ':');
+}
+inline int ValueInJSONFlow(const StreamCharSource& source) {
+  return Look(source, 0) == ':' ? 1 : -1;
+}
+inline int EndScalarInFlow(const StreamCharSource& source) {
+  int n = Indicator<EndScalarInFlowTail>(source, ':');
+  if (n >= 0) {
+    return n;
+  }
+  return Is(Look(source, 0), FLOW_END) ? 1 : -1;
+}
+inline int ScanScalarEnd(const StreamCharSource& source) {
+  int n = Value(source);
+  return n >= 0 ? n : SpacedComment(source);
+}
+inline int ScanScalarEndInFlow(const StreamCharSource& source) {
+  int n = EndScalarInFlow(source);
+  return n >= 0 ? n : SpacedComment(source);
+}
+inline int EscBreak(const StreamCharSource& source) {
+  return Indicator<BreakAt>(source, '\\');
+}
+inline int Anchor(const StreamCharSource& source) {
+  int ch = Look(source, 0);
+  if (ch < 0 || Is(ch, ANCHOR_STOP | BLANK) || BreakAt(source, 0) >= 0) {
+    return -1;
+  }
+  return 1;
+}
+inline int AnchorEnd(const StreamCharSource& source) {
+  return Is(Look(source, 0), ANCHOR_END | BLANK) ? 1 : BreakAt(source, 0);
+}
+inline int PlainScalar(const StreamCharSource& source) {
+  int ch = Look(source, 0);
+  if (ch < 0 || Is(ch, PLAIN_STOP | BLANK) || BreakAt(source, 0) >= 0) {
+    return -1;
+  }
+  if (Is(ch, PLAIN_PREFIX) && BlankOrBreakOrEndAt(source, 1) >= 0) {
+    return -1;
+  }
+  return 1;
+}
+inline int PlainScalarInFlow(const StreamCharSource& source) {
+  int ch = Look(source, 0);
+  if (ch < 0 || Is(ch, PLAIN_FLOW_STOP | BLANK) || BreakAt(source, 0) >= 0) {
+    return -1;
+  }
+  if (Is(ch, PLAIN_FLOW_PREFIX) && Is(Look(source, 1), BLANK)) {
+    return -1;
+  }
+  return 1;
+}
+// RegEx('\'') & !EscSingleQuote()
+inline int SingleQuoteEnd(const StreamCharSource& source) {
+  return Look(source, 0) == '\'' && Look(source, 1) != '\'' ? 1 : -1;
+}
+inline int DoubleQuoteEnd(const StreamCharSource& source) {
+  return Look(source, 0) == '"' ? 1 : -1;
+}
+}  // namespace detail
+
+// A compiled expression, with RegEx's Match and Matches on a Stream
+class Matcher {
+ public:
+  typedef int (*Function)(const StreamCharSource& source);
+
+  Matcher() : m_function(nullptr) {}
+  explicit Matcher(Function function) : m_function(function) {}
+
+  explicit operator bool() const { return m_function != nullptr; }
+  int Match(const Stream& in) const {
+    return m_function(StreamCharSource(in));
+  }
+  bool Matches(const Stream& in) const { return Match(in) >= 0; }
+
+ private:
+  Function m_function;
+};
+
+inline Matcher Empty() { return Matcher(&detail::Empty); }
+inline Matcher Blank() { return Matcher(&detail::Blank); }
+inline Matcher Tab() { return Matcher(&detail::Tab); }
+inline Matcher Break() { return Matcher(&detail::Break); }
+inline Matcher BlankOrBreak() { return Matcher(&detail::BlankOrBreak); }
+inline Matcher Comment() { return Matcher(&detail::Comment); }
+inline Matcher DocStart() { return Matcher(&detail::DocStart); }
+inline Matcher DocEnd() { return Matcher(&detail::DocEnd); }
+inline Matcher DocIndicator() {
+  return Matcher(static_cast<Matcher::Function>(&detail::DocIndicator));
+}
+inline Matcher BlockEntry() { return Matcher(&detail::BlockEntry); }
+inline Matcher Key() { return Matcher(&detail::Key); }
+inline Matcher KeyInFlow() { return Matcher(&detail::Key); }
+inline Matcher Value() { return Matcher(&detail::Value); }
+inline Matcher ValueInFlow() { return Matcher(&detail::ValueInFlow); }
+inline Matcher ValueInJSONFlow() { return Matcher(&detail::ValueInJSONFlow); }
+inline Matcher EndScalarInFlow() { return Matcher(&detail::EndScalarInFlow); }
+inline Matcher ScanScalarEnd() { return Matcher(&detail::ScanScalarEnd); }
+inline Matcher ScanScalarEndInFlow() {
+  return Matcher(&detail::ScanScalarEndInFlow);
+}
+inline Matcher EscBreak() { return Matcher(&detail::EscBreak); }
+inline Matcher Anchor() { return Matcher(&detail::Anchor); }
+inline Matcher AnchorEnd() { return Matcher(&detail::AnchorEnd); }
+inline Matcher PlainScalar() { return Matcher(&detail::PlainScalar); }
+inline Matcher PlainScalarInFlow() {
+  return Matcher(&detail::PlainScalarInFlow);
+}
+inline Matcher SingleQuoteEnd() { return Matcher(&detail::SingleQuoteEnd); }
+inline Matcher DoubleQuoteEnd() { return Matcher(&detail::DoubleQuoteEnd); }
+
+// Length of the run of characters at the start of [begin, end) that can't
+// end any kind of scalar or start an escape. Blanks, breaks and the end of
+// stream marker all stop the run, so ScanScalar can append it in one go.
+std::size_t ScalarText(const char* begin, const char* end);
+}  // namespace Fast
 }  // namespace Exp
 
 namespace Keys {
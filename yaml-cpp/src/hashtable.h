@@ -0,0 +1,124 @@
+#ifndef HASHTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define HASHTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace YAML {
+
+// Open addressing hash table with linear probing, for the anchor tables the
+// parser and NodeEvents look up once per node. Entries are only ever added,
+// so there are no tombstones. The hash is scrambled by a multiply before
+// it's reduced, since std::hash of a pointer is usually the address itself.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class HashTable {
+ public:
+  HashTable() : m_slots{}, m_size(0), m_shift(64) {}
+
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  // Makes room for 'count' entries without growing again
+  void reserve(std::size_t count) {
+    std::size_t capacity = 16;
+    while (capacity * 3 < count * 4) {
+      capacity *= 2;
+    }
+    if (capacity > m_slots.size()) {
+      Rehash(capacity);
+    }
+  }
+
+  // The value for 'key', default constructed if it wasn't there
+  Value& operator[](const Key& key) {
+    if ((m_size + 1) * 4 > m_slots.size() * 3) {
+      Rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+    }
+    for (std::size_t i = Index(key);; i = (i + 1) & (m_slots.size() - 1)) {
+      Slot& slot = m_slots[i];
+      if (!slot.used) {
+        slot.used = true;
+        slot.key = key;
+        m_size++;
+        return slot.value;
+      }
+      if (slot.key == key) {
+        return slot.value;
+      }
+    }
+  }
+
+  // The value for 'key', or null if it isn't there
+  const Value* find(const Key& key) const {
+    if (m_slots.empty()) {
+      return nullptr;
+    }
+    for (std::size_t i = Index(key);; i = (i + 1) & (m_slots.size() - 1)) {
+      const Slot& slot = m_slots[i];
+      if (!slot.used) {
+        return nullptr;
+      }
+      if (slot.key == key) {
+        return &slot.value;
+      }
+    }
+  }
+
+  void clear() {
+    m_slots.clear();
+    m_size = 0;
+    m_shift = 64;
+  }
+
+ private:
+  struct Slot {
+    Slot() : used(false), key{}, value{} {}
+
+    bool used;
+    Key key;
+    Value value;
+  };
+
+  std::size_t Index(const Key& key) const {
+    std::uint64_t hash = static_cast<std::uint64_t>(Hash()(key));
+    return static_cast<std::size_t>((hash * 0x9e3779b97f4a7c15ull) >> m_shift);
+  }
+
+  // 'capacity' is always a power of two
+  void Rehash(std::size_t capacity) {
+    std::vector<Slot> slots(capacity);
+    m_slots.swap(slots);
+    m_shift = 64;
+    for (std::size_t i = capacity; i > 1; i >>= 1) {
+      m_shift--;
+    }
+    for (Slot& old : slots) {
+      if (!old.used) {
+        continue;
+      }
+      std::size_t i = Index(old.key);
+      while (m_slots[i].used) {
+        i = (i + 1) & (capacity - 1);
+      }
+      m_slots[i].used = true;
+      m_slots[i].key = std::move(old.key);
+      m_slots[i].value = std::move(old.value);
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  std::size_t m_size;
+  unsigned m_shift;
+};
+}  // namespace YAML
+
+#endif  // HASHTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -8,19 +8,20 @@
 
 namespace YAML {
 void NodeEvents::AliasManager::RegisterReference(const detail::node& node) {
-  m_anchorByIdentity.insert(std::make_pair(node.ref(), _CreateNewAnchor()));
+  m_anchorByIdentity[node.ref()] = _CreateNewAnchor();
 }
 
 anchor_t NodeEvents::AliasManager::LookupAnchor(
     const detail::node& node) const {
-  AnchorByIdentity::const_iterator it = m_anchorByIdentity.find(node.ref());
-  if (it == m_anchorByIdentity.end())
-    return 0;
-  return it->second;
+  const anchor_t* anchor = m_anchorByIdentity.find(node.ref());
+  return anchor ? *anchor : 0;
 }
 
 NodeEvents::NodeEvents(const Node& node)
-    : m_pMemory(node.m_pMemory), m_root(node.m_pNode), m_refCount{} {
+    : m_pMemory(node.m_pMemory),
+      m_root(node.m_pNode),
+      m_refCount{},
+      m_aliased(0) {
   if (m_root)
     Setup(*m_root);
 }
@@ -28,6 +29,8 @@ NodeEvents::NodeEvents(const Node& node)
 void NodeEvents::Setup(const detail::node& node) {
   int& refCount = m_refCount[node.ref()];
   refCount++;
+  if (refCount == 2)
+    m_aliased++;
   if (refCount > 1)
     return;
 
@@ -44,7 +47,7 @@ void NodeEvents::Setup(const detail::node& node) {
 }
 
 void NodeEvents::Emit(EventHandler& handler) {
-  AliasManager am;
+  AliasManager am(m_aliased);
 
   handler.OnDocumentStart(Mark());
   if (m_root)
@@ -95,7 +98,7 @@ void NodeEvents::Emit(const detail::node& node, EventHandler& handler,
 }
 
 bool NodeEvents::IsAliased(const detail::node& node) const {
-  RefCount::const_iterator it = m_refCount.find(node.ref());
-  return it != m_refCount.end() && it->second > 1;
+  const int* refCount = m_refCount.find(node.ref());
+  return refCount && *refCount > 1;
 }
 }  // namespace YAML
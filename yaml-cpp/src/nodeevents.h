@@ -7,9 +7,9 @@
 #pragma once
 #endif
 
-#include <map>
 #include <vector>
 
+#include "hashtable.h"
 #include "yaml-cpp/anchor.h"
 #include "yaml-cpp/node/ptr.h"
 
@@ -36,7 +36,10 @@ class NodeEvents {
  private:
   class AliasManager {
    public:
-    AliasManager() : m_anchorByIdentity{}, m_curAnchor(0) {}
+    explicit AliasManager(std::size_t aliased)
+        : m_anchorByIdentity{}, m_curAnchor(0) {
+      m_anchorByIdentity.reserve(aliased);
+    }
 
     void RegisterReference(const detail::node& node);
     anchor_t LookupAnchor(const detail::node& node) const;
@@ -45,7 +48,7 @@ class NodeEvents {
     anchor_t _CreateNewAnchor() { return ++m_curAnchor; }
 
    private:
-    using AnchorByIdentity = std::map<const detail::node_ref*, anchor_t>;
+    using AnchorByIdentity = HashTable<const detail::node_ref*, anchor_t>;
     AnchorByIdentity m_anchorByIdentity;
 
     anchor_t m_curAnchor;
@@ -60,8 +63,9 @@ class NodeEvents {
   detail::shared_memory_holder m_pMemory;
   detail::node* m_root;
 
-  using RefCount = std::map<const detail::node_ref*, int>;
+  using RefCount = HashTable<const detail::node_ref*, int>;
   RefCount m_refCount;
+  std::size_t m_aliased;  // nodes with more than one reference
 };
 }  // namespace YAML
 
@@ -24,16 +24,7 @@ ostream_wrapper::ostream_wrapper(std::ostream& stream)
 ostream_wrapper::~ostream_wrapper() = default;
 
 void ostream_wrapper::write(const std::string& str) {
-  if (m_pStream) {
-    m_pStream->write(str.c_str(), str.size());
-  } else {
-    m_buffer.resize(std::max(m_buffer.size(), m_pos + str.size() + 1));
-    std::copy(str.begin(), str.end(), m_buffer.begin() + m_pos);
-  }
-
-  for (char ch : str) {
-    update_pos(ch);
-  }
+  write(str.data(), str.size());
 }
 
 void ostream_wrapper::write(const char* str, std::size_t size) {
@@ -44,19 +35,29 @@ void ostream_wrapper::write(const char* str, std::size_t size) {
     std::copy(str, str + size, m_buffer.begin() + m_pos);
   }
 
-  for (std::size_t i = 0; i < size; i++) {
-    update_pos(str[i]);
-  }
+  update_pos(str, size);
 }
 
-void ostream_wrapper::update_pos(char ch) {
-  m_pos++;
-  m_col++;
-
-  if (ch == '\n') {
+// update_pos
+// . Moves past the whole span at once: only the line breaks in it matter,
+//   and the column restarts after the last one.
+void ostream_wrapper::update_pos(const char* str, std::size_t size) {
+  m_pos += size;
+
+  const char* lastBreak = nullptr;
+  for (const char* next = str;
+       (next = static_cast<const char*>(
+            std::memchr(next, '\n', size - (next - str)))) != nullptr;
+       ++next) {
     m_row++;
-    m_col = 0;
+    lastBreak = next;
+  }
+
+  if (lastBreak) {
+    m_col = size - (lastBreak + 1 - str);
     m_comment = false;
+  } else {
+    m_col += size;
   }
 }
 }  // namespace YAML
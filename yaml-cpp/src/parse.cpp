@@ -62,6 +62,16 @@ std::vector<Node> LoadAll(std::istream& input) {
   return docs;
 }
 
+bool LoadNext(Parser& parser, Node& document) {
+  NodeBuilder builder;
+  if (!parser.HandleNextDocument(builder)) {
+    return false;
+  }
+
+  document.reset(builder.Root());
+  return true;
+}
+
 std::vector<Node> LoadAllFromFile(const std::string& filename) {
   std::ifstream fin(filename.c_str());
   if (!fin) {
@@ -108,11 +108,11 @@ void Scanner::ScanNextToken() {
   }
 
   // document token
-  if (INPUT.column() == 0 && Exp::DocStart().Matches(INPUT)) {
+  if (INPUT.column() == 0 && Exp::Fast::DocStart().Matches(INPUT)) {
     return ScanDocStart();
   }
 
-  if (INPUT.column() == 0 && Exp::DocEnd().Matches(INPUT)) {
+  if (INPUT.column() == 0 && Exp::Fast::DocEnd().Matches(INPUT)) {
     return ScanDocEnd();
   }
 
@@ -131,11 +131,12 @@ void Scanner::ScanNextToken() {
   }
 
   // block/map stuff
-  if (Exp::BlockEntry().Matches(INPUT)) {
+  if (Exp::Fast::BlockEntry().Matches(INPUT)) {
     return ScanBlockEntry();
   }
 
-  if ((InBlockContext() ? Exp::Key() : Exp::KeyInFlow()).Matches(INPUT)) {
+  if ((InBlockContext() ? Exp::Fast::Key() : Exp::Fast::KeyInFlow())
+          .Matches(INPUT)) {
     return ScanKey();
   }
 
@@ -164,7 +165,8 @@ void Scanner::ScanNextToken() {
   }
 
   // plain scalars
-  if ((InBlockContext() ? Exp::PlainScalar() : Exp::PlainScalarInFlow())
+  if ((InBlockContext() ? Exp::Fast::PlainScalar()
+                        : Exp::Fast::PlainScalarInFlow())
           .Matches(INPUT)) {
     return ScanPlainScalar();
   }
@@ -177,27 +179,27 @@ void Scanner::ScanToNextToken() {
   while (1) {
     // first eat whitespace
     while (INPUT && IsWhitespaceToBeEaten(INPUT.peek())) {
-      if (InBlockContext() && Exp::Tab().Matches(INPUT)) {
+      if (InBlockContext() && Exp::Fast::Tab().Matches(INPUT)) {
         m_simpleKeyAllowed = false;
       }
       INPUT.eat(1);
     }
 
     // then eat a comment
-    if (Exp::Comment().Matches(INPUT)) {
+    if (Exp::Fast::Comment().Matches(INPUT)) {
       // eat until line break
-      while (INPUT && !Exp::Break().Matches(INPUT)) {
+      while (INPUT && !Exp::Fast::Break().Matches(INPUT)) {
         INPUT.eat(1);
       }
     }
 
     // if it's NOT a line break, then we're done!
-    if (!Exp::Break().Matches(INPUT)) {
+    if (!Exp::Fast::Break().Matches(INPUT)) {
       break;
     }
 
     // otherwise, let's eat the line break and keep going
-    int n = Exp::Break().Match(INPUT);
+    int n = Exp::Fast::Break().Match(INPUT);
     INPUT.eat(n);
 
     // oh yeah, and let's get rid of that simple key
@@ -234,12 +236,13 @@ bool Scanner::IsWhitespaceToBeEaten(char ch) {
   return false;
 }
 
-const RegEx& Scanner::GetValueRegex() const {
+Exp::Fast::Matcher Scanner::GetValueRegex() const {
   if (InBlockContext()) {
-    return Exp::Value();
+    return Exp::Fast::Value();
   }
 
-  return m_canBeJSONFlow ? Exp::ValueInJSONFlow() : Exp::ValueInFlow();
+  return m_canBeJSONFlow ? Exp::Fast::ValueInJSONFlow()
+                         : Exp::Fast::ValueInFlow();
 }
 
 void Scanner::StartStream() {
@@ -265,8 +268,7 @@ void Scanner::EndStream() {
 }
 
 Token* Scanner::PushToken(Token::TYPE type) {
-  m_tokens.push(Token(type, INPUT.mark()));
-  return &m_tokens.back();
+  return &m_tokens.push(type, INPUT.mark());
 }
 
 Token::TYPE Scanner::GetStartTokenFor(IndentMarker::INDENT_TYPE type) const {
@@ -327,7 +329,7 @@ void Scanner::PopIndentToHere() {
     }
     if (indent.column == INPUT.column() &&
         !(indent.type == IndentMarker::SEQ &&
-          !Exp::BlockEntry().Matches(INPUT))) {
+          !Exp::Fast::BlockEntry().Matches(INPUT))) {
       break;
     }
 
@@ -367,9 +369,9 @@ void Scanner::PopIndent() {
   }
 
   if (indent.type == IndentMarker::SEQ) {
-    m_tokens.push(Token(Token::BLOCK_SEQ_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_SEQ_END, INPUT.mark());
   } else if (indent.type == IndentMarker::MAP) {
-    m_tokens.push(Token(Token::BLOCK_MAP_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_MAP_END, INPUT.mark());
   }
 }
 
@@ -10,19 +10,19 @@
 #include <cstddef>
 #include <ios>
 #include <map>
-#include <queue>
 #include <set>
 #include <stack>
 #include <string>
 
+#include "exp.h"
 #include "ptr_vector.h"
 #include "stream.h"
 #include "token.h"
+#include "tokenqueue.h"
 #include "yaml-cpp/mark.h"
 
 namespace YAML {
 class Node;
-class RegEx;
 
 /**
  * A scanner transforms a stream of characters into a stream of tokens.
@@ -134,9 +134,9 @@ class Scanner {
   bool IsWhitespaceToBeEaten(char ch);
 
   /**
-   * Returns the appropriate regex to check if the next token is a value token.
+   * Returns the appropriate matcher to check if the next token is a value token.
    */
-  const RegEx &GetValueRegex() const;
+  Exp::Fast::Matcher GetValueRegex() const;
 
   struct SimpleKey {
     SimpleKey(const Mark &mark_, std::size_t flowLevel_);
@@ -174,7 +174,7 @@ class Scanner {
   Stream INPUT;
 
   // the output (tokens)
-  std::queue<Token> m_tokens;
+  TokenQueue m_tokens;
 
   // state info
   bool m_startedStream, m_endedStream;
@@ -18,18 +18,18 @@ namespace YAML {
 //
 // . Depending on the parameters given, we store or stop
 //   and different places in the above flow.
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
+void ScanScalar(Stream& INPUT, ScanScalarParams& params,
+                std::string& scalar) {
   bool foundNonEmptyLine = false;
   bool pastOpeningBreak = (params.fold == FOLD_FLOW);
   bool emptyLine = false, moreIndented = false;
   int foldedNewlineCount = 0;
   bool foldedNewlineStartedMoreIndented = false;
   std::size_t lastEscapedChar = std::string::npos;
-  std::string scalar;
   params.leadingSpaces = false;
 
   if (!params.end) {
-    params.end = &Exp::Empty();
+    params.end = Exp::Fast::Empty();
   }
 
   while (INPUT) {
@@ -38,13 +38,13 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
     std::size_t lastNonWhitespaceChar = scalar.size();
     bool escapedNewline = false;
-    while (!params.end->Matches(INPUT) && !Exp::Break().Matches(INPUT)) {
+    while (!params.end.Matches(INPUT) && !Exp::Fast::Break().Matches(INPUT)) {
       if (!INPUT) {
         break;
       }
 
       // document indicator?
-      if (INPUT.column() == 0 && Exp::DocIndicator().Matches(INPUT)) {
+      if (INPUT.column() == 0 && Exp::Fast::DocIndicator().Matches(INPUT)) {
         if (params.onDocIndicator == BREAK) {
           break;
         } else if (params.onDocIndicator == THROW) {
@@ -56,7 +56,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       pastOpeningBreak = true;
 
       // escaped newline? (only if we're escaping on slash)
-      if (params.escape == '\\' && Exp::EscBreak().Matches(INPUT)) {
+      if (params.escape == '\\' && Exp::Fast::EscBreak().Matches(INPUT)) {
         // eat escape character and get out (but preserve trailing whitespace!)
         INPUT.get();
         lastNonWhitespaceChar = scalar.size();
@@ -79,6 +79,11 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       if (ch != ' ' && ch != '\t') {
         lastNonWhitespaceChar = scalar.size();
       }
+
+      // and the text after it, up to anything that could end the scalar
+      if (INPUT.ReadRun(scalar, &Exp::Fast::ScalarText) > 0) {
+        lastNonWhitespaceChar = scalar.size();
+      }
     }
 
     // eof? if we're looking to eat something, then we throw
@@ -91,12 +96,12 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
     // doc indicator?
     if (params.onDocIndicator == BREAK && INPUT.column() == 0 &&
-        Exp::DocIndicator().Matches(INPUT)) {
+        Exp::Fast::DocIndicator().Matches(INPUT)) {
       break;
     }
 
     // are we done via character match?
-    int n = params.end->Match(INPUT);
+    int n = params.end.Match(INPUT);
     if (n >= 0) {
       if (params.eatEnd) {
         INPUT.eat(n);
@@ -110,7 +115,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
     // ********************************
     // Phase #2: eat line ending
-    n = Exp::Break().Match(INPUT);
+    n = Exp::Fast::Break().Match(INPUT);
     INPUT.eat(n);
 
     // ********************************
@@ -120,7 +125,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     while (INPUT.peek() == ' ' &&
            (INPUT.column() < params.indent ||
             (params.detectIndent && !foundNonEmptyLine)) &&
-           !params.end->Matches(INPUT)) {
+           !params.end.Matches(INPUT)) {
       INPUT.eat(1);
     }
 
@@ -130,7 +135,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     }
 
     // and then the rest of the whitespace
-    while (Exp::Blank().Matches(INPUT)) {
+    while (Exp::Fast::Blank().Matches(INPUT)) {
       // we check for tabs that masquerade as indentation
       if (INPUT.peek() == '\t' && INPUT.column() < params.indent &&
           params.onTabInIndentation == THROW) {
@@ -141,7 +146,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
         break;
       }
 
-      if (params.end->Matches(INPUT)) {
+      if (params.end.Matches(INPUT)) {
         break;
       }
 
@@ -149,8 +154,8 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     }
 
     // was this an empty line?
-    bool nextEmptyLine = Exp::Break().Matches(INPUT);
-    bool nextMoreIndented = Exp::Blank().Matches(INPUT);
+    bool nextEmptyLine = Exp::Fast::Break().Matches(INPUT);
+    bool nextMoreIndented = Exp::Fast::Blank().Matches(INPUT);
     if (params.fold == FOLD_BLOCK && foldedNewlineCount == 0 && nextEmptyLine)
       foldedNewlineStartedMoreIndented = moreIndented;
 
@@ -244,7 +249,5 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     default:
       break;
   }
-
-  return scalar;
 }
 }
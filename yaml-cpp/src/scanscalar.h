@@ -9,7 +9,7 @@
 
 #include <string>
 
-#include "regex_yaml.h"
+#include "exp.h"
 #include "stream.h"
 
 namespace YAML {
@@ -33,8 +33,7 @@ struct ScanScalarParams {
         leadingSpaces(false) {}
 
   // input:
-  const RegEx* end;   // what condition ends this scalar?
-                      // unowned.
+  Exp::Fast::Matcher end;  // what condition ends this scalar?
   bool eatEnd;        // should we eat that condition when we see it?
   int indent;         // what level of indentation should be eaten and ignored?
   bool detectIndent;  // should we try to autodetect the indent?
@@ -57,7 +56,8 @@ struct ScanScalarParams {
   bool leadingSpaces;
 };
 
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& info);
+// Scans into 'scalar', which should be empty
+void ScanScalar(Stream& INPUT, ScanScalarParams& info, std::string& scalar);
 }
 
 #endif  // SCANSCALAR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
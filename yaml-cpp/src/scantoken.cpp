@@ -18,9 +18,6 @@ namespace YAML {
 // Directive
 // . Note: no semantic checking is done here (that's for the parser to do)
 void Scanner::ScanDirective() {
-  std::string name;
-  std::vector<std::string> params;
-
   // pop indents and simple keys
   PopAllIndents();
   PopAllSimpleKeys();
@@ -29,32 +26,31 @@ void Scanner::ScanDirective() {
   m_canBeJSONFlow = false;
 
   // store pos and eat indicator
-  Token token(Token::DIRECTIVE, INPUT.mark());
+  Token& token = m_tokens.push(Token::DIRECTIVE, INPUT.mark());
   INPUT.eat(1);
 
   // read name
-  while (INPUT && !Exp::BlankOrBreak().Matches(INPUT))
+  while (INPUT && !Exp::Fast::BlankOrBreak().Matches(INPUT))
     token.value += INPUT.get();
 
   // read parameters
   while (1) {
     // first get rid of whitespace
-    while (Exp::Blank().Matches(INPUT))
+    while (Exp::Fast::Blank().Matches(INPUT))
       INPUT.eat(1);
 
     // break on newline or comment
-    if (!INPUT || Exp::Break().Matches(INPUT) || Exp::Comment().Matches(INPUT))
+    if (!INPUT || Exp::Fast::Break().Matches(INPUT) ||
+        Exp::Fast::Comment().Matches(INPUT))
       break;
 
     // now read parameter
     std::string param;
-    while (INPUT && !Exp::BlankOrBreak().Matches(INPUT))
+    while (INPUT && !Exp::Fast::BlankOrBreak().Matches(INPUT))
       param += INPUT.get();
 
     token.params.push_back(param);
   }
-
-  m_tokens.push(token);
 }
 
 // DocStart
@@ -67,7 +63,7 @@ void Scanner::ScanDocStart() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_START, mark));
+  m_tokens.push(Token::DOC_START, mark);
 }
 
 // DocEnd
@@ -80,7 +76,7 @@ void Scanner::ScanDocEnd() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_END, mark));
+  m_tokens.push(Token::DOC_END, mark);
 }
 
 // FlowStart
@@ -97,7 +93,7 @@ void Scanner::ScanFlowStart() {
   m_flows.push(flowType);
   Token::TYPE type =
       (flowType == FLOW_SEQ ? Token::FLOW_SEQ_START : Token::FLOW_MAP_START);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEnd
@@ -108,7 +104,7 @@ void Scanner::ScanFlowEnd() {
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
     if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
+      m_tokens.push(Token::VALUE, INPUT.mark());
     else if (m_flows.top() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
@@ -127,7 +123,7 @@ void Scanner::ScanFlowEnd() {
   m_flows.pop();
 
   Token::TYPE type = (flowType ? Token::FLOW_SEQ_END : Token::FLOW_MAP_END);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEntry
@@ -135,7 +131,7 @@ void Scanner::ScanFlowEntry() {
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
     if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
+      m_tokens.push(Token::VALUE, INPUT.mark());
     else if (m_flows.top() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
@@ -146,7 +142,7 @@ void Scanner::ScanFlowEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::FLOW_ENTRY, mark));
+  m_tokens.push(Token::FLOW_ENTRY, mark);
 }
 
 // BlockEntry
@@ -166,7 +162,7 @@ void Scanner::ScanBlockEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::BLOCK_ENTRY, mark));
+  m_tokens.push(Token::BLOCK_ENTRY, mark);
 }
 
 // Key
@@ -185,7 +181,7 @@ void Scanner::ScanKey() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::KEY, mark));
+  m_tokens.push(Token::KEY, mark);
 }
 
 // Value
@@ -214,7 +210,7 @@ void Scanner::ScanValue() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::VALUE, mark));
+  m_tokens.push(Token::VALUE, mark);
 }
 
 // AnchorOrAlias
@@ -233,7 +229,7 @@ void Scanner::ScanAnchorOrAlias() {
   alias = (indicator == Keys::Alias);
 
   // now eat the content
-  while (INPUT && Exp::Anchor().Matches(INPUT))
+  while (INPUT && Exp::Fast::Anchor().Matches(INPUT))
     name += INPUT.get();
 
   // we need to have read SOMETHING!
@@ -242,14 +238,12 @@ void Scanner::ScanAnchorOrAlias() {
                                               : ErrorMsg::ANCHOR_NOT_FOUND);
 
   // and needs to end correctly
-  if (INPUT && !Exp::AnchorEnd().Matches(INPUT))
+  if (INPUT && !Exp::Fast::AnchorEnd().Matches(INPUT))
     throw ParserException(INPUT.mark(), alias ? ErrorMsg::CHAR_IN_ALIAS
                                               : ErrorMsg::CHAR_IN_ANCHOR);
 
   // and we're done
-  Token token(alias ? Token::ALIAS : Token::ANCHOR, mark);
-  token.value = name;
-  m_tokens.push(token);
+  m_tokens.push(alias ? Token::ALIAS : Token::ANCHOR, mark).value = name;
 }
 
 // Tag
@@ -259,7 +253,7 @@ void Scanner::ScanTag() {
   m_simpleKeyAllowed = false;
   m_canBeJSONFlow = false;
 
-  Token token(Token::TAG, INPUT.mark());
+  Token& token = m_tokens.push(Token::TAG, INPUT.mark());
 
   // eat the indicator
   INPUT.get();
@@ -287,18 +281,14 @@ void Scanner::ScanTag() {
       token.data = Tag::NAMED_HANDLE;
     }
   }
-
-  m_tokens.push(token);
 }
 
 // PlainScalar
 void Scanner::ScanPlainScalar() {
-  std::string scalar;
-
   // set up the scanning parameters
   ScanScalarParams params;
-  params.end =
-      (InFlowContext() ? &Exp::ScanScalarEndInFlow() : &Exp::ScanScalarEnd());
+  params.end = (InFlowContext() ? Exp::Fast::ScanScalarEndInFlow()
+                                : Exp::Fast::ScanScalarEnd());
   params.eatEnd = false;
   params.indent = (InFlowContext() ? 0 : GetTopIndent() + 1);
   params.fold = FOLD_FLOW;
@@ -311,8 +301,9 @@ void Scanner::ScanPlainScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
-  scalar = ScanScalar(INPUT, params);
+  // the scalar is scanned straight into its token
+  Token& token = m_tokens.push(Token::PLAIN_SCALAR, INPUT.mark());
+  ScanScalar(INPUT, params, token.value);
 
   // can have a simple key only if we ended the scalar by starting a new line
   m_simpleKeyAllowed = params.leadingSpaces;
@@ -321,16 +312,10 @@ void Scanner::ScanPlainScalar() {
   // finally, check and see if we ended on an illegal character
   // if(Exp::IllegalCharInScalar.Matches(INPUT))
   //	throw ParserException(INPUT.mark(), ErrorMsg::CHAR_IN_SCALAR);
-
-  Token token(Token::PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 
 // QuotedScalar
 void Scanner::ScanQuotedScalar() {
-  std::string scalar;
-
   // peek at single or double quote (don't eat because we need to preserve (for
   // the time being) the input position)
   char quote = INPUT.peek();
@@ -338,8 +323,8 @@ void Scanner::ScanQuotedScalar() {
 
   // setup the scanning parameters
   ScanScalarParams params;
-  RegEx end = (single ? RegEx(quote) & !Exp::EscSingleQuote() : RegEx(quote));
-  params.end = &end;
+  params.end = (single ? Exp::Fast::SingleQuoteEnd()
+                       : Exp::Fast::DoubleQuoteEnd());
   params.eatEnd = true;
   params.escape = (single ? '\'' : '\\');
   params.indent = 0;
@@ -352,19 +337,15 @@ void Scanner::ScanQuotedScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
+  Token& token = m_tokens.push(Token::NON_PLAIN_SCALAR, INPUT.mark());
 
   // now eat that opening quote
   INPUT.get();
 
   // and scan
-  scalar = ScanScalar(INPUT, params);
+  ScanScalar(INPUT, params, token.value);
   m_simpleKeyAllowed = false;
   m_canBeJSONFlow = true;
-
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 
 // BlockScalarToken
@@ -373,8 +354,6 @@ void Scanner::ScanQuotedScalar() {
 // of the scalar),
 //   and then we need to figure out what level of indentation we'll be using.
 void Scanner::ScanBlockScalar() {
-  std::string scalar;
-
   ScanScalarParams params;
   params.indent = 1;
   params.detectIndent = true;
@@ -403,16 +382,16 @@ void Scanner::ScanBlockScalar() {
   }
 
   // now eat whitespace
-  while (Exp::Blank().Matches(INPUT))
+  while (Exp::Fast::Blank().Matches(INPUT))
     INPUT.eat(1);
 
   // and comments to the end of the line
-  if (Exp::Comment().Matches(INPUT))
-    while (INPUT && !Exp::Break().Matches(INPUT))
+  if (Exp::Fast::Comment().Matches(INPUT))
+    while (INPUT && !Exp::Fast::Break().Matches(INPUT))
       INPUT.eat(1);
 
   // if it's not a line break, then we ran into a bad character inline
-  if (INPUT && !Exp::Break().Matches(INPUT))
+  if (INPUT && !Exp::Fast::Break().Matches(INPUT))
     throw ParserException(INPUT.mark(), ErrorMsg::CHAR_IN_BLOCK);
 
   // set the initial indentation
@@ -423,15 +402,12 @@ void Scanner::ScanBlockScalar() {
   params.trimTrailingSpaces = false;
   params.onTabInIndentation = THROW;
 
-  scalar = ScanScalar(INPUT, params);
+  Token& token = m_tokens.push(Token::NON_PLAIN_SCALAR, mark);
+  ScanScalar(INPUT, params, token.value);
 
   // simple keys always ok after block scalars (since we're gonna start a new
   // line anyways)
   m_simpleKeyAllowed = true;
   m_canBeJSONFlow = false;
-
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 }  // namespace YAML
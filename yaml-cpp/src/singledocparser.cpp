@@ -413,10 +413,10 @@ anchor_t SingleDocParser::RegisterAnchor(const std::string& name) {
 
 anchor_t SingleDocParser::LookupAnchor(const Mark& mark,
                                        const std::string& name) const {
-  Anchors::const_iterator it = m_anchors.find(name);
-  if (it == m_anchors.end())
+  const anchor_t* anchor = m_anchors.find(name);
+  if (!anchor)
     throw ParserException(mark, ErrorMsg::UNKNOWN_ANCHOR);
 
-  return it->second;
+  return *anchor;
 }
 }  // namespace YAML
@@ -7,10 +7,10 @@
 #pragma once
 #endif
 
-#include <map>
 #include <memory>
 #include <string>
 
+#include "hashtable.h"
 #include "yaml-cpp/anchor.h"
 
 namespace YAML {
@@ -59,7 +59,7 @@ class SingleDocParser {
   const Directives& m_directives;
   std::unique_ptr<CollectionStack> m_pCollectionStack;
 
-  using Anchors = std::map<std::string, anchor_t>;
+  using Anchors = HashTable<std::string, anchor_t>;
   Anchors m_anchors;
 
   anchor_t m_curAnchor;
@@ -399,6 +399,40 @@ inline char* ReadBuffer(unsigned char* pBuffer) {
   return reinterpret_cast<char*>(pBuffer);
 }
 
+// ReadRun
+// . Appends the run of characters ahead that 'run' accepts (it returns how
+//   many characters at the start of a range it accepts) and returns its
+//   length. The run must not contain line breaks or the end of stream marker.
+// . Once the readahead is used up, UTF-8 input is scanned straight out of the
+//   prefetch buffer, so long runs skip the readahead altogether.
+std::size_t Stream::ReadRun(std::string& out,
+                            std::size_t (*run)(const char*, const char*)) {
+  std::size_t length = 0;
+  while (!m_readahead.empty()) {
+    char ch = m_readahead.front();
+    if (run(&ch, &ch + 1) == 0) {
+      break;
+    }
+    out += ch;
+    m_readahead.pop_front();
+    length++;
+  }
+
+  if (m_readahead.empty() && m_charSet == utf8) {
+    const char* begin = ReadBuffer(m_pPrefetched) + m_nPrefetchedUsed;
+    const char* end = ReadBuffer(m_pPrefetched) + m_nPrefetchedAvailable;
+    std::size_t n = run(begin, end);
+    out.append(begin, n);
+    m_nPrefetchedUsed += n;
+    length += n;
+  }
+
+  m_mark.pos += static_cast<int>(length);
+  m_mark.column += static_cast<int>(length);
+  ReadAheadTo(0);
+  return length;
+}
+
 unsigned char Stream::GetNextByte() const {
   if (m_nPrefetchedUsed >= m_nPrefetchedAvailable) {
     std::streambuf* pBuf = m_input.rdbuf();
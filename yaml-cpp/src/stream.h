@@ -34,6 +34,8 @@ class Stream {
   char get();
   std::string get(int n);
   void eat(int n = 1);
+  std::size_t ReadRun(std::string& out,
+                      std::size_t (*run)(const char*, const char*));
 
   static char eof() { return 0x04; }
 
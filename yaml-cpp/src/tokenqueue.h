@@ -0,0 +1,85 @@
+#ifndef TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "token.h"
+
+namespace YAML {
+
+// The scanner's queue of tokens, kept in a ring of slots that are reused.
+// A popped token keeps its value and params buffers for the next token
+// pushed into its slot, so once the ring is as long as the longest run of
+// queued tokens, scanning stops allocating for them. Tokens never move, so
+// pointers to queued tokens stay valid until they're popped.
+class TokenQueue {
+ public:
+  TokenQueue() : m_slots{}, m_head(0), m_size(0) {}
+  TokenQueue(const TokenQueue&) = delete;
+  TokenQueue& operator=(const TokenQueue&) = delete;
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+
+  Token& front() { return *m_slots[m_head]; }
+  const Token& front() const { return *m_slots[m_head]; }
+  Token& back() { return *m_slots[Slot(m_size - 1)]; }
+  const Token& back() const { return *m_slots[Slot(m_size - 1)]; }
+
+  // Returns the new token, reset as if it were just constructed
+  Token& push(Token::TYPE type, const Mark& mark) {
+    if (m_size == m_slots.size()) {
+      Grow();
+    }
+    Token& token = *m_slots[Slot(m_size)];
+    token.status = Token::VALID;
+    token.type = type;
+    token.mark = mark;
+    token.value.clear();
+    token.params.clear();
+    token.data = 0;
+    m_size++;
+    return token;
+  }
+
+  void pop() {
+    m_head = Slot(1);
+    m_size--;
+  }
+
+ private:
+  // The number of slots is always a power of two
+  std::size_t Slot(std::size_t i) const {
+    return (m_head + i) & (m_slots.size() - 1);
+  }
+
+  void Grow() {
+    std::size_t count = m_slots.empty() ? 16 : m_slots.size() * 2;
+    std::vector<std::unique_ptr<Token>> slots;
+    slots.reserve(count);
+    for (std::size_t i = 0; i < m_slots.size(); i++) {
+      slots.push_back(std::move(m_slots[Slot(i)]));
+    }
+    while (slots.size() < count) {
+      slots.emplace_back(new Token(Token::PLAIN_SCALAR, Mark()));
+    }
+    m_slots.swap(slots);
+    m_head = 0;
+  }
+
+  std::vector<std::unique_ptr<Token>> m_slots;
+  std::size_t m_head;
+  std::size_t m_size;
+};
+}  // namespace YAML
+
+#endif  // TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66